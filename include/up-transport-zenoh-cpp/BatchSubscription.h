@@ -0,0 +1,113 @@
+// SPDX-FileCopyrightText: 2024 Contributors to the Eclipse Foundation
+//
+// See the NOTICE file(s) distributed with this work for additional
+// information regarding copyright ownership.
+//
+// This program and the accompanying materials are made available under the
+// terms of the Apache License Version 2.0 which is available at
+// https://www.apache.org/licenses/LICENSE-2.0
+//
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef UP_TRANSPORT_ZENOH_CPP_BATCHSUBSCRIPTION_H
+#define UP_TRANSPORT_ZENOH_CPP_BATCHSUBSCRIPTION_H
+
+#include <uprotocol/v1/umessage.pb.h>
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <vector>
+
+#define ZENOHCXX_ZENOHC
+#include <zenoh.hxx>
+
+namespace uprotocol::transport {
+
+/// @brief A subscription whose messages are passed to a callback in
+///        batches.
+///
+/// Decoded messages are accumulated until either max_batch of them are
+/// pending, or the oldest pending one has waited max_delay. All of them
+/// are then passed to the callback at once, from a thread owned by the
+/// subscription. The zenoh thread only decodes and appends each message,
+/// so a callback taking its time doesn't hold up other subscribers.
+///
+/// Batches are delivered one at a time, in the order messages arrived.
+class BatchSubscription {
+public:
+	struct Config {
+		/// Number of pending messages that triggers a delivery. Batches
+		/// are larger when messages arrive faster than the callback
+		/// handles them, as each batch takes every pending message.
+		size_t max_batch = 64;
+		/// Longest a message is held waiting for its batch to fill up.
+		std::chrono::microseconds max_delay{1000};
+		/// Maximum number of pending messages, including those of a full
+		/// batch not delivered yet because the callback is still busy with
+		/// the previous one. Messages arriving beyond that are dropped.
+		size_t capacity = 65536;
+	};
+
+	/// @brief Called with each batch. The messages are only valid during
+	///        the call, but may be moved from. Exceptions thrown by the
+	///        callback are logged, and the next batch is still delivered.
+	using Callback = std::function<void(std::vector<v1::UMessage>&)>;
+
+	/// @brief Turns a sample into a message, or returns nothing if the
+	///        sample is to be skipped.
+	using Decoder =
+	    std::function<std::optional<v1::UMessage>(const zenoh::Sample&)>;
+
+	/// @brief Declares a subscriber on zenoh_key.
+	///
+	/// @throws zenoh::ZException if the subscriber can't be declared.
+	BatchSubscription(const zenoh::Session& session,
+	                  const std::string& zenoh_key, const Config& config,
+	                  Decoder decoder, Callback callback);
+
+	/// @brief Undeclares the subscriber, then delivers any pending
+	///        messages before returning.
+	~BatchSubscription();
+
+	BatchSubscription(const BatchSubscription&) = delete;
+	BatchSubscription& operator=(const BatchSubscription&) = delete;
+	BatchSubscription(BatchSubscription&&) = delete;
+	BatchSubscription& operator=(BatchSubscription&&) = delete;
+
+	/// @brief Number of messages dropped because capacity was reached.
+	[[nodiscard]] uint64_t dropped() const { return dropped_; }
+
+private:
+	using Clock = std::chrono::steady_clock;
+
+	void onSample_(const zenoh::Sample& sample);
+
+	void run_();
+
+	const Config config_;
+	Decoder decoder_;
+	Callback callback_;
+
+	std::vector<v1::UMessage> pending_;
+	// Arrival of the first message in pending_
+	Clock::time_point pending_since_;
+	bool stop_ = false;
+	std::mutex mutex_;
+	std::condition_variable cv_;
+	std::atomic<uint64_t> dropped_ = 0;
+
+	std::thread deliverer_;
+
+	// NOTE: Declared last, and reset first by the destructor, so that no
+	// sample arrives while the members above are being torn down.
+	std::optional<zenoh::Subscriber<void>> subscriber_;
+};
+
+}  // namespace uprotocol::transport
+
+#endif  // UP_TRANSPORT_ZENOH_CPP_BATCHSUBSCRIPTION_H
@@ -0,0 +1,79 @@
+// SPDX-FileCopyrightText: 2024 Contributors to the Eclipse Foundation
+//
+// See the NOTICE file(s) distributed with this work for additional
+// information regarding copyright ownership.
+//
+// This program and the accompanying materials are made available under the
+// terms of the Apache License Version 2.0 which is available at
+// https://www.apache.org/licenses/LICENSE-2.0
+//
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef UP_TRANSPORT_ZENOH_CPP_DUPLICATEFILTER_H
+#define UP_TRANSPORT_ZENOH_CPP_DUPLICATEFILTER_H
+
+#include <uprotocol/v1/uuid.pb.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace uprotocol::transport {
+
+/// @brief Detects message ids seen recently, to suppress duplicate
+///        deliveries of the same message.
+///
+/// Ids are kept in fixed-size open addressing tables, split into shards
+/// with their own lock so that concurrent callers rarely contend. An id is
+/// remembered for the window, or until its slot is needed for a newer id
+/// once the filter is full, so memory use is bounded and no allocation
+/// happens after construction. A duplicate arriving after its id has been
+/// forgotten is not detected.
+class DuplicateFilter {
+public:
+	using Clock = std::chrono::steady_clock;
+
+	struct Config {
+		/// Maximum number of ids remembered. Rounded up to a multiple of
+		/// the number of shards.
+		size_t capacity = 4096;
+		/// How long an id is remembered for.
+		std::chrono::milliseconds window{1000};
+		size_t shards = 16;
+	};
+
+	explicit DuplicateFilter(const Config& config);
+
+	/// @brief Checks if an id has been seen within the window, and
+	///        remembers it if it hasn't.
+	///
+	/// The nil (all zero) id is never treated as a duplicate.
+	bool isDuplicate(const v1::UUID& id, Clock::time_point now = Clock::now());
+
+	/// @brief Number of ids found to be duplicates.
+	[[nodiscard]] uint64_t suppressed() const { return suppressed_; }
+
+private:
+	struct Slot {
+		uint64_t msb = 0;
+		uint64_t lsb = 0;
+		Clock::time_point seen;
+	};
+
+	struct alignas(64) Shard {
+		std::mutex mutex;
+		std::vector<Slot> slots;
+	};
+
+	const Clock::duration window_;
+	const size_t num_shards_;
+	std::unique_ptr<Shard[]> shards_;  // NOLINT(*-avoid-c-arrays)
+	std::atomic<uint64_t> suppressed_ = 0;
+};
+
+}  // namespace uprotocol::transport
+
+#endif  // UP_TRANSPORT_ZENOH_CPP_DUPLICATEFILTER_H
@@ -0,0 +1,101 @@
+// SPDX-FileCopyrightText: 2024 Contributors to the Eclipse Foundation
+//
+// See the NOTICE file(s) distributed with this work for additional
+// information regarding copyright ownership.
+//
+// This program and the accompanying materials are made available under the
+// terms of the Apache License Version 2.0 which is available at
+// https://www.apache.org/licenses/LICENSE-2.0
+//
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef UP_TRANSPORT_ZENOH_CPP_LATESTVALUEMAILBOX_H
+#define UP_TRANSPORT_ZENOH_CPP_LATESTVALUEMAILBOX_H
+
+#include <uprotocol/v1/umessage.pb.h>
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+
+namespace uprotocol::transport {
+
+/// @brief Single-slot mailbox holding only the latest received message.
+///
+/// Register the callback returned by listener() with a transport, then
+/// take messages from the consumer's own thread. A consumer that falls
+/// behind skips straight to the newest message instead of working through
+/// a backlog of stale ones.
+class LatestValueMailbox
+    : public std::enable_shared_from_this<LatestValueMailbox> {
+public:
+	/// @brief Creates an empty mailbox.
+	///
+	/// Mailboxes are always shared so that listener() can keep them alive.
+	static std::shared_ptr<LatestValueMailbox> create() {
+		return std::shared_ptr<LatestValueMailbox>(new LatestValueMailbox());
+	}
+
+	/// @brief Listener callback that stores messages in this mailbox.
+	///
+	/// The callback keeps the mailbox alive.
+	std::function<void(const v1::UMessage&)> listener() {
+		return [self = shared_from_this()](const v1::UMessage& message) {
+			self->put(message);
+		};
+	}
+
+	/// @brief Stores a message, replacing any message not yet taken.
+	void put(const v1::UMessage& message) {
+		{
+			std::lock_guard<std::mutex> lock(mutex_);
+			if (latest_.has_value()) {
+				++overwritten_;
+			}
+			latest_ = message;
+		}
+		cv_.notify_one();
+	}
+
+	/// @brief Takes the latest message, if there is one.
+	std::optional<v1::UMessage> take() {
+		std::lock_guard<std::mutex> lock(mutex_);
+		return takeLocked();
+	}
+
+	/// @brief Takes the latest message, waiting up to timeout for one to
+	///        arrive.
+	std::optional<v1::UMessage> takeFor(std::chrono::milliseconds timeout) {
+		std::unique_lock<std::mutex> lock(mutex_);
+		cv_.wait_for(lock, timeout, [this]() { return latest_.has_value(); });
+		return takeLocked();
+	}
+
+	/// @brief Number of messages replaced before they were taken.
+	[[nodiscard]] uint64_t overwritten() const {
+		std::lock_guard<std::mutex> lock(mutex_);
+		return overwritten_;
+	}
+
+private:
+	LatestValueMailbox() = default;
+
+	std::optional<v1::UMessage> takeLocked() {
+		std::optional<v1::UMessage> message;
+		message.swap(latest_);
+		return message;
+	}
+
+	std::optional<v1::UMessage> latest_;
+	uint64_t overwritten_ = 0;
+	mutable std::mutex mutex_;
+	std::condition_variable cv_;
+};
+
+}  // namespace uprotocol::transport
+
+#endif  // UP_TRANSPORT_ZENOH_CPP_LATESTVALUEMAILBOX_H
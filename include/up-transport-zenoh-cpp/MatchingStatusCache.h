@@ -0,0 +1,89 @@
+// SPDX-FileCopyrightText: 2024 Contributors to the Eclipse Foundation
+//
+// See the NOTICE file(s) distributed with this work for additional
+// information regarding copyright ownership.
+//
+// This program and the accompanying materials are made available under the
+// terms of the Apache License Version 2.0 which is available at
+// https://www.apache.org/licenses/LICENSE-2.0
+//
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef UP_TRANSPORT_ZENOH_CPP_MATCHINGSTATUSCACHE_H
+#define UP_TRANSPORT_ZENOH_CPP_MATCHINGSTATUSCACHE_H
+
+#include <atomic>
+#include <functional>
+#include <map>
+#include <memory>
+#include <optional>
+#include <shared_mutex>
+#include <string>
+
+#define ZENOHCXX_ZENOHC
+#include <zenoh.hxx>
+
+namespace uprotocol::transport {
+
+/// @brief Tracks, per zenoh key, whether any subscriber currently matches
+///        that key.
+///
+/// A zenoh publisher is declared for each tracked key, and its matching
+/// status is kept up to date by a matching listener. Matching status
+/// updates are asynchronous, so a subscriber that has only just been
+/// declared may not be seen yet.
+///
+/// Checking a key that is already tracked only takes a shared lock, so
+/// concurrent senders don't serialize on the cache.
+///
+/// @remarks Matching status is part of the zenoh unstable API. When zenoh
+///          is built without it, every key is reported as having
+///          subscribers.
+class MatchingStatusCache {
+public:
+	/// @param session Session to declare publishers on. Must outlive the
+	///                cache.
+	/// @param capacity Maximum number of keys to track. Keys beyond that
+	///                 are reported as having subscribers.
+	MatchingStatusCache(const zenoh::Session& session, size_t capacity);
+
+	/// @brief Checks if a key may have subscribers.
+	///
+	/// Starts tracking the key if it isn't tracked yet, which declares its
+	/// publisher.
+	///
+	/// @returns false only if the key is known to have no subscribers.
+	bool hasSubscribers(const std::string& zenoh_key);
+
+	/// @brief Number of tracked keys.
+	[[nodiscard]] size_t size() const;
+
+	/// @brief Whether the zenoh build provides matching status.
+	static constexpr bool isSupported() {
+#if defined(Z_FEATURE_UNSTABLE_API)
+		return true;
+#else
+		return false;
+#endif
+	}
+
+private:
+	struct Entry {
+		zenoh::Publisher publisher;
+		std::shared_ptr<std::atomic<bool>> matching;
+	};
+
+	const zenoh::Session& session_;
+	const size_t capacity_;
+
+	/// Declares the publisher of a key, and returns an entry tracking its
+	/// matching status.
+	std::optional<Entry> track_(const std::string& zenoh_key) const;
+
+	std::map<std::string, Entry, std::less<>> entries_;
+	mutable std::shared_mutex mutex_;
+};
+
+}  // namespace uprotocol::transport
+
+#endif  // UP_TRANSPORT_ZENOH_CPP_MATCHINGSTATUSCACHE_H
@@ -0,0 +1,117 @@
+// SPDX-FileCopyrightText: 2024 Contributors to the Eclipse Foundation
+//
+// See the NOTICE file(s) distributed with this work for additional
+// information regarding copyright ownership.
+//
+// This program and the accompanying materials are made available under the
+// terms of the Apache License Version 2.0 which is available at
+// https://www.apache.org/licenses/LICENSE-2.0
+//
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef UP_TRANSPORT_ZENOH_CPP_PULLSUBSCRIPTION_H
+#define UP_TRANSPORT_ZENOH_CPP_PULLSUBSCRIPTION_H
+
+#include <uprotocol/v1/umessage.pb.h>
+
+#include <chrono>
+#include <functional>
+#include <optional>
+#include <variant>
+#include <vector>
+
+#define ZENOHCXX_ZENOHC
+#include <zenoh.hxx>
+
+namespace uprotocol::transport {
+
+/// @brief A subscription whose messages are pulled by the application
+///        instead of being pushed to a callback.
+///
+/// Samples are queued as they arrive in a zenoh channel (a RingChannel or
+/// a FifoChannel, depending on the overflow policy), and only decoded into
+/// UMessages when they are received. There is no transport thread between
+/// zenoh and the application.
+///
+/// Receiving is thread-safe, but each message is only received once.
+///
+/// @remarks Zenoh channels can't be waited on with a timeout, so receive()
+///          polls the channel while it waits, backing off up to 1ms
+///          between polls. A message that arrives during a wait may be
+///          received up to that much later than it would be by a
+///          listener. Use tryReceive() or drain() from an existing event
+///          loop to avoid this.
+class PullSubscription {
+public:
+	/// @brief What happens when a message arrives while the queue is full.
+	enum class OverflowPolicy {
+		/// The oldest queued message is dropped (RingChannel).
+		DROP_OLDEST,
+		/// The zenoh thread delivering the message blocks until there is
+		/// room (FifoChannel). This pushes back on every subscriber of the
+		/// session, so the queue must be drained promptly.
+		BLOCK
+	};
+
+	struct Config {
+		/// Maximum number of queued messages.
+		size_t capacity = 1024;
+		OverflowPolicy overflow = OverflowPolicy::DROP_OLDEST;
+	};
+
+	/// @brief Turns a sample into a message, or returns nothing if the
+	///        sample is to be skipped.
+	using Decoder =
+	    std::function<std::optional<v1::UMessage>(const zenoh::Sample&)>;
+
+	/// @brief Declares a subscriber on zenoh_key.
+	///
+	/// @throws zenoh::ZException if the subscriber can't be declared.
+	PullSubscription(const zenoh::Session& session,
+	                 const std::string& zenoh_key, const Config& config,
+	                 Decoder decoder);
+
+	/// @brief Undeclares the subscriber. A zenoh thread blocked on a full
+	///        queue is released, and its message dropped.
+	~PullSubscription() = default;
+
+	PullSubscription(const PullSubscription&) = delete;
+	PullSubscription& operator=(const PullSubscription&) = delete;
+	PullSubscription(PullSubscription&&) = delete;
+	PullSubscription& operator=(PullSubscription&&) = delete;
+
+	/// @brief Receives a queued message without waiting.
+	std::optional<v1::UMessage> tryReceive();
+
+	/// @brief Receives a message, waiting up to timeout for one to arrive.
+	std::optional<v1::UMessage> receive(std::chrono::milliseconds timeout);
+
+	/// @brief Appends up to max_messages queued messages to messages,
+	///        without waiting.
+	///
+	/// @returns The number of messages appended.
+	size_t drain(std::vector<v1::UMessage>& messages, size_t max_messages);
+
+private:
+	using RingSubscriber =
+	    zenoh::Subscriber<zenoh::channels::RingHandler<zenoh::Sample>>;
+	using FifoSubscriber =
+	    zenoh::Subscriber<zenoh::channels::FifoHandler<zenoh::Sample>>;
+	using AnySubscriber = std::variant<RingSubscriber, FifoSubscriber>;
+
+	static AnySubscriber declare_(const zenoh::Session& session,
+	                              const std::string& zenoh_key,
+	                              const Config& config);
+
+	/// Takes the oldest queued sample, polling until deadline for one if
+	/// there is none.
+	std::optional<zenoh::Sample> takeSample_(
+	    std::optional<std::chrono::steady_clock::time_point> deadline);
+
+	Decoder decoder_;
+	AnySubscriber subscriber_;
+};
+
+}  // namespace uprotocol::transport
+
+#endif  // UP_TRANSPORT_ZENOH_CPP_PULLSUBSCRIPTION_H
@@ -0,0 +1,118 @@
+// SPDX-FileCopyrightText: 2024 Contributors to the Eclipse Foundation
+//
+// See the NOTICE file(s) distributed with this work for additional
+// information regarding copyright ownership.
+//
+// This program and the accompanying materials are made available under the
+// terms of the Apache License Version 2.0 which is available at
+// https://www.apache.org/licenses/LICENSE-2.0
+//
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef UP_TRANSPORT_ZENOH_CPP_RECEIVESCHEDULER_H
+#define UP_TRANSPORT_ZENOH_CPP_RECEIVESCHEDULER_H
+
+#include <uprotocol/v1/uattributes.pb.h>
+
+#include <array>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <thread>
+
+namespace uprotocol::transport {
+
+/// @brief Dispatches received messages to listeners from per-priority
+///        queues instead of in arrival order on the zenoh thread.
+///
+/// Tasks are posted with the UPriority of the message they deliver. Each
+/// priority has its own bounded queue, and worker threads pick the next
+/// task according to the configured Policy. Optionally, priorities at or
+/// above a threshold are served by a dedicated "high priority lane" thread
+/// that can be pinned to a CPU core so that control traffic is never
+/// queued behind bulk traffic.
+class ReceiveScheduler {
+public:
+	using Task = std::function<void()>;
+
+	/// @brief Number of UPriority values, including UPRIORITY_UNSPECIFIED.
+	static constexpr size_t NUM_PRIORITIES = 8;
+
+	enum class Policy {
+		/// Always run the highest priority task available.
+		STRICT_PRIORITY,
+		/// Serve each priority in proportion to its weight, so that lower
+		/// priorities are not starved under sustained high-priority load.
+		WEIGHTED
+	};
+
+	struct Config {
+		Policy policy = Policy::STRICT_PRIORITY;
+
+		/// @brief Relative weights, indexed by UPriority value. Only used
+		///        with Policy::WEIGHTED. A weight of 0 is treated as 1.
+		std::array<uint32_t, NUM_PRIORITIES> weights = {1,  1, 1,  2,
+		                                                4,  8, 16, 32};
+
+		/// @brief Maximum number of pending tasks per priority. Tasks
+		///        posted to a full queue are dropped.
+		size_t queue_capacity = 4096;
+
+		/// @brief Serve priorities >= high_priority_threshold on their own
+		///        thread.
+		bool dedicated_high_priority_lane = false;
+		v1::UPriority high_priority_threshold = v1::UPriority::UPRIORITY_CS5;
+
+		/// @brief CPU core the high priority lane thread is pinned to.
+		///        Ignored if the lane is not enabled or on platforms
+		///        without thread affinity support.
+		std::optional<unsigned int> high_priority_cpu;
+	};
+
+	explicit ReceiveScheduler(const Config& config);
+	~ReceiveScheduler();
+
+	ReceiveScheduler(const ReceiveScheduler&) = delete;
+	ReceiveScheduler& operator=(const ReceiveScheduler&) = delete;
+	ReceiveScheduler(ReceiveScheduler&&) = delete;
+	ReceiveScheduler& operator=(ReceiveScheduler&&) = delete;
+
+	/// @brief Queue a task for dispatch at the given priority.
+	///
+	/// @returns true if the task was queued, false if the queue for that
+	///          priority was full and the task was dropped.
+	bool post(v1::UPriority priority, Task&& task);
+
+	/// @brief Number of tasks dropped because their queue was full.
+	[[nodiscard]] uint64_t dropped() const { return dropped_; }
+
+private:
+	struct Lane {
+		std::mutex mutex;
+		std::condition_variable cv;
+		std::array<std::deque<Task>, NUM_PRIORITIES> queues;
+		std::array<uint32_t, NUM_PRIORITIES> credits{};
+		bool stop = false;
+		std::thread worker;
+	};
+
+	static size_t priorityIndex(v1::UPriority priority);
+
+	void run(Lane& lane);
+	std::optional<Task> next(Lane& lane);
+	void stop(Lane& lane);
+
+	const Config config_;
+	std::atomic<uint64_t> dropped_{0};
+
+	Lane normal_lane_;
+	std::unique_ptr<Lane> high_lane_;
+};
+
+}  // namespace uprotocol::transport
+
+#endif  // UP_TRANSPORT_ZENOH_CPP_RECEIVESCHEDULER_H
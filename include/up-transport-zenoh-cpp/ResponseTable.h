@@ -0,0 +1,134 @@
+// SPDX-FileCopyrightText: 2024 Contributors to the Eclipse Foundation
+//
+// See the NOTICE file(s) distributed with this work for additional
+// information regarding copyright ownership.
+//
+// This program and the accompanying materials are made available under the
+// terms of the Apache License Version 2.0 which is available at
+// https://www.apache.org/licenses/LICENSE-2.0
+//
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef UP_TRANSPORT_ZENOH_CPP_RESPONSETABLE_H
+#define UP_TRANSPORT_ZENOH_CPP_RESPONSETABLE_H
+
+#include <up-cpp/utils/Expected.h>
+#include <uprotocol/v1/umessage.pb.h>
+#include <uprotocol/v1/uri.pb.h>
+#include <uprotocol/v1/ustatus.pb.h>
+
+#include <array>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <optional>
+#include <queue>
+#include <thread>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace uprotocol::transport {
+
+/// @brief Handlers waiting for RPC responses, keyed by request id.
+///
+/// Each handler only accepts a response from the entity its request was
+/// sent to, so that another entity can't answer (or cancel) it.
+///
+/// The table is split into shards, each with its own lock, so that
+/// concurrent calls rarely contend. Handlers that haven't been taken when
+/// their request's TTL runs out are removed and called with a
+/// DEADLINE_EXCEEDED status from the table's expiry thread.
+class ResponseTable {
+public:
+	using ResponseOrStatus = utils::Expected<v1::UMessage, v1::UStatus>;
+	using Handler = std::function<void(ResponseOrStatus)>;
+	using Clock = std::chrono::steady_clock;
+
+	ResponseTable();
+	~ResponseTable();
+
+	ResponseTable(const ResponseTable&) = delete;
+	ResponseTable& operator=(const ResponseTable&) = delete;
+	ResponseTable(ResponseTable&&) = delete;
+	ResponseTable& operator=(ResponseTable&&) = delete;
+
+	/// @brief Adds a handler for the response to a request.
+	///
+	/// @param responder The request's sink, which must be the source of
+	///                  the response.
+	///
+	/// @returns false if a handler for this request id already exists.
+	bool expect(const v1::UUID& reqid, const v1::UUri& responder,
+	            std::chrono::milliseconds ttl, Handler&& handler);
+
+	/// @brief Removes and returns the handler for a response, if it is
+	///        still waiting and the response came from the expected
+	///        responder.
+	///
+	/// A handler is left waiting when the source doesn't match.
+	std::optional<Handler> take(const v1::UUID& reqid,
+	                            const v1::UUri& source);
+
+	/// @brief Removes and returns the handler for a request id, if it is
+	///        still waiting, whoever it expects a response from.
+	std::optional<Handler> take(const v1::UUID& reqid);
+
+	/// @brief Number of handlers waiting.
+	[[nodiscard]] size_t size() const;
+
+private:
+	static constexpr size_t NUM_SHARDS = 16;
+
+	using Key = std::pair<uint64_t, uint64_t>;
+
+	struct KeyHash {
+		size_t operator()(const Key& key) const {
+			// The low bits of a UUIDv7 lsb are random
+			return static_cast<size_t>(key.second ^ (key.first * 31));
+		}
+	};
+
+	struct Waiter {
+		Handler handler;
+		v1::UUri responder;
+	};
+
+	struct Shard {
+		mutable std::mutex mutex;
+		std::unordered_map<Key, Waiter, KeyHash> handlers;
+	};
+
+	struct Deadline {
+		Clock::time_point when;
+		Key key;
+		bool operator>(const Deadline& other) const {
+			return when > other.when;
+		}
+	};
+
+	static Key toKey(const v1::UUID& uuid) { return {uuid.msb(), uuid.lsb()}; }
+
+	Shard& shardFor(const Key& key) {
+		return shards_[KeyHash{}(key) % NUM_SHARDS];
+	}
+
+	std::optional<Handler> take(const Key& key, const v1::UUri* source);
+
+	void expire();
+
+	std::array<Shard, NUM_SHARDS> shards_;
+
+	std::priority_queue<Deadline, std::vector<Deadline>, std::greater<>>
+	    deadlines_;
+	bool stop_ = false;
+	std::mutex deadlines_mutex_;
+	std::condition_variable deadlines_cv_;
+	std::thread expiry_thread_;
+};
+
+}  // namespace uprotocol::transport
+
+#endif  // UP_TRANSPORT_ZENOH_CPP_RESPONSETABLE_H
@@ -0,0 +1,97 @@
+// SPDX-FileCopyrightText: 2024 Contributors to the Eclipse Foundation
+//
+// See the NOTICE file(s) distributed with this work for additional
+// information regarding copyright ownership.
+//
+// This program and the accompanying materials are made available under the
+// terms of the Apache License Version 2.0 which is available at
+// https://www.apache.org/licenses/LICENSE-2.0
+//
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef UP_TRANSPORT_ZENOH_CPP_SENDCONFLATOR_H
+#define UP_TRANSPORT_ZENOH_CPP_SENDCONFLATOR_H
+
+#include <uprotocol/v1/umessage.pb.h>
+
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <thread>
+
+#include "TopicCounters.h"
+
+namespace uprotocol::transport {
+
+/// @brief Limits the send rate of selected keys by keeping only the latest
+///        pending message per key.
+///
+/// A message offered on a conflated key is sent right away if at least the
+/// key's minimum interval has passed since the last send. Otherwise it is
+/// held back and replaces any message already held for that key. Held
+/// messages are flushed from a background thread as soon as their key's
+/// interval has passed.
+class SendConflator {
+public:
+	using Clock = std::chrono::steady_clock;
+
+	/// @brief Called to send a message that was held back.
+	using Flush =
+	    std::function<void(const std::string& zenoh_key, const v1::UMessage&)>;
+
+	enum class Action {
+		/// The key is not conflated or is due: send the message now.
+		SEND_NOW,
+		/// The message is held and will be flushed later.
+		DEFERRED
+	};
+
+	/// @param intervals Minimum interval between sends, per zenoh key.
+	/// @param flush Callback for held back messages. Called from the
+	///              conflator's thread.
+	SendConflator(const std::map<std::string, std::chrono::milliseconds>&
+	                  intervals,
+	              Flush&& flush);
+	/// @brief Flushes any held messages, without waiting for their
+	///        intervals, then stops the conflator's thread.
+	~SendConflator();
+
+	SendConflator(const SendConflator&) = delete;
+	SendConflator& operator=(const SendConflator&) = delete;
+	SendConflator(SendConflator&&) = delete;
+	SendConflator& operator=(SendConflator&&) = delete;
+
+	Action offer(const std::string& zenoh_key, const v1::UMessage& message);
+
+	/// @brief Per-key counts of messages replaced by a newer message
+	///        before they could be sent.
+	[[nodiscard]] TopicCounters::Snapshot conflated() const {
+		return conflated_.snapshot();
+	}
+
+private:
+	struct Slot {
+		std::chrono::milliseconds interval;
+		Clock::time_point last_sent;
+		std::optional<v1::UMessage> pending;
+	};
+
+	void run();
+
+	Flush flush_;
+	TopicCounters conflated_;
+
+	std::map<std::string, Slot, std::less<>> slots_;
+	bool stop_ = false;
+	std::mutex mutex_;
+	std::condition_variable cv_;
+	std::thread flusher_;
+};
+
+}  // namespace uprotocol::transport
+
+#endif  // UP_TRANSPORT_ZENOH_CPP_SENDCONFLATOR_H
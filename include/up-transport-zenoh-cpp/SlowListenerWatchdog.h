@@ -0,0 +1,171 @@
+// SPDX-FileCopyrightText: 2024 Contributors to the Eclipse Foundation
+//
+// See the NOTICE file(s) distributed with this work for additional
+// information regarding copyright ownership.
+//
+// This program and the accompanying materials are made available under the
+// terms of the Apache License Version 2.0 which is available at
+// https://www.apache.org/licenses/LICENSE-2.0
+//
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef UP_TRANSPORT_ZENOH_CPP_SLOWLISTENERWATCHDOG_H
+#define UP_TRANSPORT_ZENOH_CPP_SLOWLISTENERWATCHDOG_H
+
+#include <uprotocol/v1/uri.pb.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <optional>
+#include <string_view>
+
+#include "TopicLatencies.h"
+
+namespace uprotocol::transport {
+
+/// @brief A listener call that took longer than the watchdog threshold.
+struct SlowListenerCall {
+	/// Zenoh key of the subscriber that received the message
+	std::string_view zenoh_key;
+	/// Filters the listener was registered with. Empty if the listener
+	/// isn't watched.
+	std::optional<v1::UUri> source_filter;
+	std::optional<v1::UUri> sink_filter;
+	/// Identifies the listener across reports. Assigned in the order
+	/// watched listeners were first found to be slow, starting from 1.
+	/// 0 if the listener isn't watched, such as a listener forgotten
+	/// while the call was running.
+	uint64_t listener_id;
+	std::chrono::nanoseconds duration;
+	/// Whether later calls of this listener are run off the receiving
+	/// thread. Only watched listeners are offloaded.
+	bool offloaded;
+};
+
+struct SlowListenerConfig {
+	/// Calls taking at least this long are reported.
+	std::chrono::microseconds threshold{10000};
+
+	/// Once a listener has been slow, run its later calls on a separate
+	/// thread instead of the thread that received the message.
+	bool offload = false;
+
+	/// Called after each slow call, on the thread that made the call. Must
+	/// return quickly, and must not register or unregister listeners.
+	std::function<void(const SlowListenerCall&)> hook;
+};
+
+/// @brief Keeps track of listeners whose calls take too long.
+///
+/// The caller times each listener call and passes the duration to check().
+/// Calls that keep up cost no more than the timing. Every listener is
+/// tracked from watch() until forget(), which must be called when it is
+/// unregistered. Slow calls of a listener that isn't tracked are still
+/// reported, but the listener is neither identified nor offloaded.
+template <typename Listener>
+class SlowListenerWatchdog {
+public:
+	explicit SlowListenerWatchdog(SlowListenerConfig config)
+	    : config_(std::move(config)) {}
+
+	[[nodiscard]] bool isOffloaded(const Listener& listener) const {
+		if (num_offloaded_.load(std::memory_order_relaxed) == 0) {
+			return false;
+		}
+		std::lock_guard<std::mutex> lock(mutex_);
+		auto it = listeners_.find(listener);
+		return (it != listeners_.end()) && it->second.offloaded;
+	}
+
+	/// @brief Starts tracking a listener, remembering the filters it was
+	///        registered with so that reports of its slow calls say
+	///        which listener it is.
+	void watch(const Listener& listener, const v1::UUri& source_filter,
+	           const std::optional<v1::UUri>& sink_filter) {
+		std::lock_guard<std::mutex> lock(mutex_);
+		auto& state = listeners_[listener];
+		state.source_filter = source_filter;
+		state.sink_filter = sink_filter;
+	}
+
+	/// @brief Checks the duration of a call, and reports it if it was
+	///        slow.
+	///
+	/// @returns The report, if the call was slow.
+	std::optional<SlowListenerCall> check(std::string_view zenoh_key,
+	                                      const Listener& listener,
+	                                      std::chrono::nanoseconds duration) {
+		if (duration < config_.threshold) {
+			return std::nullopt;
+		}
+		durations_.add(zenoh_key, duration);
+
+		SlowListenerCall call{zenoh_key, std::nullopt, std::nullopt, 0,
+		                      duration, false};
+		{
+			std::lock_guard<std::mutex> lock(mutex_);
+			// A listener that isn't tracked may have been forgotten while
+			// the call ran, and must not be tracked again.
+			auto it = listeners_.find(listener);
+			if (it != listeners_.end()) {
+				auto& state = it->second;
+				if (state.id == 0) {
+					state.id = ++last_id_;
+				}
+				if (config_.offload && !state.offloaded) {
+					state.offloaded = true;
+					++num_offloaded_;
+				}
+				call.source_filter = state.source_filter;
+				call.sink_filter = state.sink_filter;
+				call.listener_id = state.id;
+				call.offloaded = state.offloaded;
+			}
+		}
+		if (config_.hook) {
+			config_.hook(call);
+		}
+		return call;
+	}
+
+	void forget(const Listener& listener) {
+		std::lock_guard<std::mutex> lock(mutex_);
+		auto it = listeners_.find(listener);
+		if (it != listeners_.end()) {
+			if (it->second.offloaded) {
+				--num_offloaded_;
+			}
+			listeners_.erase(it);
+		}
+	}
+
+	/// @brief Per-key histograms of the durations of slow calls.
+	[[nodiscard]] TopicLatencies::Snapshot slowCalls() const {
+		return durations_.snapshot();
+	}
+
+private:
+	struct State {
+		// 0 until the listener is first slow
+		uint64_t id = 0;
+		bool offloaded = false;
+		std::optional<v1::UUri> source_filter;
+		std::optional<v1::UUri> sink_filter;
+	};
+
+	const SlowListenerConfig config_;
+	TopicLatencies durations_;
+
+	std::map<Listener, State> listeners_;
+	uint64_t last_id_ = 0;
+	std::atomic<size_t> num_offloaded_ = 0;
+	mutable std::mutex mutex_;
+};
+
+}  // namespace uprotocol::transport
+
+#endif  // UP_TRANSPORT_ZENOH_CPP_SLOWLISTENERWATCHDOG_H
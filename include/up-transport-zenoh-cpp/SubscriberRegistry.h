@@ -0,0 +1,184 @@
+// SPDX-FileCopyrightText: 2024 Contributors to the Eclipse Foundation
+//
+// See the NOTICE file(s) distributed with this work for additional
+// information regarding copyright ownership.
+//
+// This program and the accompanying materials are made available under the
+// terms of the Apache License Version 2.0 which is available at
+// https://www.apache.org/licenses/LICENSE-2.0
+//
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef UP_TRANSPORT_ZENOH_CPP_SUBSCRIBERREGISTRY_H
+#define UP_TRANSPORT_ZENOH_CPP_SUBSCRIBERREGISTRY_H
+
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <utility>
+#include <vector>
+
+/// @brief Thread-safe registry of subscriptions, keyed by zenoh key, where
+///        all listeners registered on the same key share one subscription.
+///
+/// A subscription's callback holds a shared_ptr to the ListenerSet of its
+/// key and dispatches each sample to every listener in it.
+template <typename Listener, typename Subscription>
+class SubscriberRegistry {
+public:
+	using Listeners = std::vector<Listener>;
+
+	/// @brief Copy-on-write list of the listeners on one key.
+	///
+	/// get() is cheap and never blocks on dispatch. The returned list is
+	/// never modified after it has been published.
+	class ListenerSet {
+	public:
+		explicit ListenerSet(Listeners listeners)
+		    : listeners_(std::make_shared<Listeners>(std::move(listeners))) {}
+
+		[[nodiscard]] std::shared_ptr<Listeners> get() const {
+			std::lock_guard<std::mutex> lock(mutex_);
+			return listeners_;
+		}
+
+	private:
+		friend class SubscriberRegistry;
+
+		void add(const Listeners& listeners) {
+			std::lock_guard<std::mutex> lock(mutex_);
+			auto next = std::make_shared<Listeners>(*listeners_);
+			next->insert(next->end(), listeners.begin(), listeners.end());
+			listeners_ = std::move(next);
+		}
+
+		// Returns true if no listeners remain
+		bool remove(const Listener& listener) {
+			std::lock_guard<std::mutex> lock(mutex_);
+			auto next = std::make_shared<Listeners>();
+			for (const auto& existing : *listeners_) {
+				if (!isSame(existing, listener)) {
+					next->push_back(existing);
+				}
+			}
+			listeners_ = std::move(next);
+			return listeners_->empty();
+		}
+
+		std::shared_ptr<Listeners> listeners_;
+		mutable std::mutex mutex_;
+	};
+
+	/// @brief A subscription that has been declared but not yet inserted.
+	struct Entry {
+		std::string key;
+		std::shared_ptr<ListenerSet> listeners;
+		Subscription subscription;
+	};
+
+	/// @brief Adds listeners to the existing subscriptions on their keys.
+	///
+	/// @param groups Listeners to add, grouped by key.
+	///
+	/// @returns For each group, whether a subscription existed for its key.
+	///          Groups that return false need a new subscription.
+	std::vector<bool> attach(
+	    const std::vector<std::pair<std::string, Listeners>>& groups) {
+		std::vector<bool> attached;
+		attached.reserve(groups.size());
+
+		std::lock_guard<std::mutex> lock(mutex_);
+		for (const auto& [key, listeners] : groups) {
+			auto it = subscriptions_.find(key);
+			if (it == subscriptions_.end()) {
+				attached.push_back(false);
+				continue;
+			}
+			it->second.listeners->add(listeners);
+			for (const auto& listener : listeners) {
+				keys_.emplace(listener, key);
+			}
+			attached.push_back(true);
+		}
+		return attached;
+	}
+
+	/// @brief Inserts newly declared subscriptions.
+	///
+	/// If another subscription was inserted on the same key in the meantime,
+	/// the entry's listeners are attached to that one instead.
+	///
+	/// @returns Surplus subscriptions. These should be dropped by the caller
+	///          once it no longer holds any locks. Until then, they may
+	///          still deliver to their listeners.
+	std::vector<Subscription> insert(std::vector<Entry>&& entries) {
+		std::vector<Subscription> surplus;
+
+		std::lock_guard<std::mutex> lock(mutex_);
+		for (auto& entry : entries) {
+			const auto listeners = entry.listeners->get();
+			for (const auto& listener : *listeners) {
+				keys_.emplace(listener, entry.key);
+			}
+
+			auto it = subscriptions_.find(entry.key);
+			if (it != subscriptions_.end()) {
+				it->second.listeners->add(*listeners);
+				surplus.emplace_back(std::move(entry.subscription));
+				continue;
+			}
+			subscriptions_.emplace(
+			    std::move(entry.key),
+			    Slot{std::move(entry.listeners),
+			         std::move(entry.subscription)});
+		}
+		return surplus;
+	}
+
+	/// @brief Removes a listener from its subscription.
+	///
+	/// @returns The subscription if it has no listeners left. It should be
+	///          dropped by the caller once it no longer holds any locks.
+	std::optional<Subscription> detach(const Listener& listener) {
+		std::lock_guard<std::mutex> lock(mutex_);
+		auto key_it = keys_.find(listener);
+		if (key_it == keys_.end()) {
+			return std::nullopt;
+		}
+		auto it = subscriptions_.find(key_it->second);
+		keys_.erase(key_it);
+		if ((it == subscriptions_.end()) ||
+		    !it->second.listeners->remove(listener)) {
+			return std::nullopt;
+		}
+		std::optional<Subscription> unused(std::move(it->second.subscription));
+		subscriptions_.erase(it);
+		return unused;
+	}
+
+	/// @brief Number of subscriptions (distinct keys).
+	[[nodiscard]] size_t size() const {
+		std::lock_guard<std::mutex> lock(mutex_);
+		return subscriptions_.size();
+	}
+
+private:
+	struct Slot {
+		std::shared_ptr<ListenerSet> listeners;
+		Subscription subscription;
+	};
+
+	static bool isSame(const Listener& lhs, const Listener& rhs) {
+		return !std::less<Listener>()(lhs, rhs) &&
+		       !std::less<Listener>()(rhs, lhs);
+	}
+
+	std::map<std::string, Slot> subscriptions_;
+	std::map<Listener, std::string> keys_;
+	mutable std::mutex mutex_;
+};
+
+#endif  // UP_TRANSPORT_ZENOH_CPP_SUBSCRIBERREGISTRY_H
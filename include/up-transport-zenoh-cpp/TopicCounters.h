@@ -0,0 +1,56 @@
+// SPDX-FileCopyrightText: 2024 Contributors to the Eclipse Foundation
+//
+// See the NOTICE file(s) distributed with this work for additional
+// information regarding copyright ownership.
+//
+// This program and the accompanying materials are made available under the
+// terms of the Apache License Version 2.0 which is available at
+// https://www.apache.org/licenses/LICENSE-2.0
+//
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef UP_TRANSPORT_ZENOH_CPP_TOPICCOUNTERS_H
+#define UP_TRANSPORT_ZENOH_CPP_TOPICCOUNTERS_H
+
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <string>
+#include <string_view>
+
+namespace uprotocol::transport {
+
+/// @brief Thread-safe event counters, one per zenoh key.
+class TopicCounters {
+public:
+	using Snapshot = std::map<std::string, uint64_t>;
+
+	void increment(std::string_view key, uint64_t count = 1) {
+		std::lock_guard<std::mutex> lock(mutex_);
+		auto it = counts_.find(key);
+		if (it == counts_.end()) {
+			it = counts_.emplace(std::string(key), 0).first;
+		}
+		it->second += count;
+	}
+
+	[[nodiscard]] uint64_t get(std::string_view key) const {
+		std::lock_guard<std::mutex> lock(mutex_);
+		auto it = counts_.find(key);
+		return (it != counts_.end()) ? it->second : 0;
+	}
+
+	[[nodiscard]] Snapshot snapshot() const {
+		std::lock_guard<std::mutex> lock(mutex_);
+		return {counts_.begin(), counts_.end()};
+	}
+
+private:
+	std::map<std::string, uint64_t, std::less<>> counts_;
+	mutable std::mutex mutex_;
+};
+
+}  // namespace uprotocol::transport
+
+#endif  // UP_TRANSPORT_ZENOH_CPP_TOPICCOUNTERS_H
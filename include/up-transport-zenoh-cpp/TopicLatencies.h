@@ -0,0 +1,115 @@
+// SPDX-FileCopyrightText: 2024 Contributors to the Eclipse Foundation
+//
+// See the NOTICE file(s) distributed with this work for additional
+// information regarding copyright ownership.
+//
+// This program and the accompanying materials are made available under the
+// terms of the Apache License Version 2.0 which is available at
+// https://www.apache.org/licenses/LICENSE-2.0
+//
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef UP_TRANSPORT_ZENOH_CPP_TOPICLATENCIES_H
+#define UP_TRANSPORT_ZENOH_CPP_TOPICLATENCIES_H
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <string>
+#include <string_view>
+
+namespace uprotocol::transport {
+
+/// @brief Histogram of latencies with power of two buckets.
+///
+/// Bucket 0 counts latencies under 1us, and bucket i counts latencies from
+/// 2^(i-1)us up to (excluding) 2^i us. The last bucket also counts anything
+/// longer.
+struct LatencyHistogram {
+	static constexpr size_t NUM_BUCKETS = 32;
+
+	std::array<uint64_t, NUM_BUCKETS> buckets{};
+	uint64_t count = 0;
+	std::chrono::nanoseconds total{0};
+	std::chrono::nanoseconds max{0};
+
+	void add(std::chrono::nanoseconds latency) {
+		latency = std::max(latency, std::chrono::nanoseconds(0));
+		++buckets[bucketOf(latency)];
+		++count;
+		total += latency;
+		max = std::max(max, latency);
+	}
+
+	[[nodiscard]] std::chrono::nanoseconds mean() const {
+		if (count == 0) {
+			return {};
+		}
+		return total / static_cast<int64_t>(count);
+	}
+
+	/// @brief Upper bound of the bucket holding the given quantile (0 to
+	///        1), capped to the largest latency seen.
+	[[nodiscard]] std::chrono::nanoseconds quantile(double q) const {
+		const auto target = static_cast<uint64_t>(
+		    std::ceil(std::clamp(q, 0.0, 1.0) * static_cast<double>(count)));
+		uint64_t seen = 0;
+		for (size_t bucket = 0; bucket < NUM_BUCKETS; ++bucket) {
+			seen += buckets[bucket];
+			if ((seen > 0) && (seen >= target)) {
+				return std::min(upperBound(bucket), max);
+			}
+		}
+		return max;
+	}
+
+	static size_t bucketOf(std::chrono::nanoseconds latency) {
+		auto micros = static_cast<uint64_t>(
+		    std::chrono::duration_cast<std::chrono::microseconds>(latency)
+		        .count());
+		size_t bucket = 0;
+		while ((micros > 0) && (bucket < (NUM_BUCKETS - 1))) {
+			micros >>= 1U;
+			++bucket;
+		}
+		return bucket;
+	}
+
+	static std::chrono::nanoseconds upperBound(size_t bucket) {
+		return std::chrono::microseconds(int64_t{1} << bucket);
+	}
+};
+
+/// @brief Thread-safe latency histograms, one per zenoh key.
+class TopicLatencies {
+public:
+	using Snapshot = std::map<std::string, LatencyHistogram>;
+
+	void add(std::string_view key, std::chrono::nanoseconds latency) {
+		std::lock_guard<std::mutex> lock(mutex_);
+		auto it = histograms_.find(key);
+		if (it == histograms_.end()) {
+			it = histograms_.emplace(std::string(key), LatencyHistogram{})
+			         .first;
+		}
+		it->second.add(latency);
+	}
+
+	[[nodiscard]] Snapshot snapshot() const {
+		std::lock_guard<std::mutex> lock(mutex_);
+		return {histograms_.begin(), histograms_.end()};
+	}
+
+private:
+	std::map<std::string, LatencyHistogram, std::less<>> histograms_;
+	mutable std::mutex mutex_;
+};
+
+}  // namespace uprotocol::transport
+
+#endif  // UP_TRANSPORT_ZENOH_CPP_TOPICLATENCIES_H
@@ -0,0 +1,135 @@
+// SPDX-FileCopyrightText: 2024 Contributors to the Eclipse Foundation
+//
+// See the NOTICE file(s) distributed with this work for additional
+// information regarding copyright ownership.
+//
+// This program and the accompanying materials are made available under the
+// terms of the Apache License Version 2.0 which is available at
+// https://www.apache.org/licenses/LICENSE-2.0
+//
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef UP_TRANSPORT_ZENOH_CPP_TRAFFICRECORDER_H
+#define UP_TRANSPORT_ZENOH_CPP_TRAFFICRECORDER_H
+
+#include <uprotocol/v1/umessage.pb.h>
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+
+namespace uprotocol::transport {
+
+/// @brief Layout of traffic capture files.
+///
+/// A capture starts with a FileHeader, followed by records. Each record is
+/// a RecordHeader, the attributes in protobuf wire format and the payload,
+/// padded to a multiple of RECORD_ALIGNMENT bytes. A record header with a
+/// direction of 0 (or the end of the file) ends the capture. Integers are
+/// in host byte order.
+namespace capture_format {
+
+constexpr std::array<char, 8> MAGIC = {'U', 'P', 'Z', 'T', 'R', 'C', '0', '1'};
+constexpr size_t RECORD_ALIGNMENT = 8;
+
+enum class Direction : uint8_t { SENT = 1, RECEIVED = 2 };
+
+struct FileHeader {
+	std::array<char, 8> magic;
+	/// Start of the recording, in ns since the Unix epoch
+	uint64_t start_time_ns;
+};
+
+struct RecordHeader {
+	/// Time since the start of the recording
+	uint64_t offset_ns;
+	uint32_t attributes_size;
+	uint32_t payload_size;
+	Direction direction;
+	std::array<uint8_t, 7> reserved;
+};
+
+}  // namespace capture_format
+
+/// @brief Records messages into an append-only, memory mapped capture file.
+///
+/// The file is mapped at its full capacity up front, and each record
+/// reserves its space with a single atomic increment, so recording from
+/// many threads never takes a lock. Once the capacity is used up, further
+/// messages are counted as dropped. The file is truncated to the recorded
+/// size when the recorder is destroyed.
+class TrafficRecorder {
+public:
+	using Direction = capture_format::Direction;
+
+	/// @param file Path of the capture file. Replaced if it exists.
+	/// @param capacity Maximum size of the capture file, in bytes.
+	///
+	/// @throws std::system_error if the file can't be created or mapped.
+	TrafficRecorder(const std::filesystem::path& file, size_t capacity);
+	~TrafficRecorder();
+
+	TrafficRecorder(const TrafficRecorder&) = delete;
+	TrafficRecorder& operator=(const TrafficRecorder&) = delete;
+	TrafficRecorder(TrafficRecorder&&) = delete;
+	TrafficRecorder& operator=(TrafficRecorder&&) = delete;
+
+	void record(Direction direction, const v1::UMessage& message);
+
+	[[nodiscard]] uint64_t recorded() const { return recorded_; }
+	[[nodiscard]] uint64_t dropped() const { return dropped_; }
+
+private:
+	int fd_ = -1;
+	uint8_t* data_ = nullptr;
+	const size_t capacity_;
+	const std::chrono::steady_clock::time_point start_;
+
+	std::atomic<size_t> end_;
+	std::atomic<uint64_t> recorded_ = 0;
+	std::atomic<uint64_t> dropped_ = 0;
+};
+
+/// @brief Reads the records of a capture file, in order.
+class TrafficCapture {
+public:
+	struct Record {
+		capture_format::Direction direction;
+		std::chrono::nanoseconds offset;
+		v1::UMessage message;
+	};
+
+	/// @throws std::system_error if the file can't be opened or mapped.
+	/// @throws std::runtime_error if the file isn't a capture.
+	explicit TrafficCapture(const std::filesystem::path& file);
+	~TrafficCapture();
+
+	TrafficCapture(const TrafficCapture&) = delete;
+	TrafficCapture& operator=(const TrafficCapture&) = delete;
+	TrafficCapture(TrafficCapture&&) = delete;
+	TrafficCapture& operator=(TrafficCapture&&) = delete;
+
+	/// @brief Start of the recording.
+	[[nodiscard]] std::chrono::system_clock::time_point startTime() const;
+
+	/// @brief Reads the next record.
+	///
+	/// @returns false at the end of the capture, or if the next record is
+	///          truncated or malformed.
+	bool next(Record& record);
+
+	/// @brief Restarts reading from the first record.
+	void rewind();
+
+private:
+	int fd_ = -1;
+	const uint8_t* data_ = nullptr;
+	size_t size_ = 0;
+	size_t position_ = 0;
+};
+
+}  // namespace uprotocol::transport
+
+#endif  // UP_TRANSPORT_ZENOH_CPP_TRAFFICRECORDER_H
@@ -0,0 +1,56 @@
+// SPDX-FileCopyrightText: 2024 Contributors to the Eclipse Foundation
+//
+// See the NOTICE file(s) distributed with this work for additional
+// information regarding copyright ownership.
+//
+// This program and the accompanying materials are made available under the
+// terms of the Apache License Version 2.0 which is available at
+// https://www.apache.org/licenses/LICENSE-2.0
+//
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef UP_TRANSPORT_ZENOH_CPP_TRAFFICREPLAYER_H
+#define UP_TRANSPORT_ZENOH_CPP_TRAFFICREPLAYER_H
+
+#include <up-cpp/transport/UTransport.h>
+
+#include <cstdint>
+#include <filesystem>
+
+namespace uprotocol::transport {
+
+/// @brief Sends the messages of a capture file (see TrafficRecorder)
+///        through a transport, with the timing they were recorded with.
+struct TrafficReplayer {
+	struct Options {
+		/// @brief Replay speed relative to the recording. 2.0 replays
+		///        twice as fast, and 0 sends as fast as possible.
+		double speed = 1.0;
+
+		/// @brief Also send the messages recorded as received. By default
+		///        only messages recorded as sent are replayed.
+		bool replay_received = false;
+
+		/// @brief Give each message a new id, so that the TTL of replayed
+		///        messages is counted from the time of the replay.
+		bool new_ids = true;
+	};
+
+	struct Stats {
+		uint64_t sent = 0;
+		uint64_t failed = 0;
+	};
+
+	/// @brief Replays a capture through transport.send(). Blocks until the
+	///        last message is sent.
+	///
+	/// @throws std::system_error if the file can't be opened or mapped.
+	/// @throws std::runtime_error if the file isn't a capture.
+	static Stats replay(UTransport& transport,
+	                    const std::filesystem::path& file,
+	                    const Options& options);
+};
+
+}  // namespace uprotocol::transport
+
+#endif  // UP_TRANSPORT_ZENOH_CPP_TRAFFICREPLAYER_H
@@ -0,0 +1,126 @@
+// SPDX-FileCopyrightText: 2024 Contributors to the Eclipse Foundation
+//
+// See the NOTICE file(s) distributed with this work for additional
+// information regarding copyright ownership.
+//
+// This program and the accompanying materials are made available under the
+// terms of the Apache License Version 2.0 which is available at
+// https://www.apache.org/licenses/LICENSE-2.0
+//
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef UP_TRANSPORT_ZENOH_CPP_TRAFFICSHAPER_H
+#define UP_TRANSPORT_ZENOH_CPP_TRAFFICSHAPER_H
+
+#include <uprotocol/v1/umessage.pb.h>
+
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace uprotocol::transport {
+
+/// @brief Limits the bandwidth of selected outgoing traffic with token
+///        buckets.
+///
+/// Each rule selects messages by priority, source entity and/or zenoh key
+/// prefix, and has its own bucket. A message is charged to the first rule
+/// that selects it, by the size of its attributes and payload. Messages
+/// selected by no rule are not limited.
+///
+/// A message larger than its rule's burst size is sent once the bucket is
+/// full, and leaves the bucket in debt by the difference, so the messages
+/// after it wait until the sustained rate is met again.
+class TrafficShaper {
+public:
+	using Clock = std::chrono::steady_clock;
+
+	/// @brief What happens to a message that exceeds its rule's limit.
+	enum class OverLimit {
+		/// The sending thread waits until the bucket has refilled enough,
+		/// up to max_delay. Messages that would wait longer are rejected.
+		DELAY,
+		/// The message is silently discarded.
+		DROP,
+		/// The message is not sent, and send() fails with
+		/// RESOURCE_EXHAUSTED.
+		REJECT
+	};
+
+	struct Rule {
+		/// @brief Selectors. A message must match every selector that is
+		///        set. A rule with no selectors matches every message.
+		std::optional<v1::UPriority> priority;
+		std::optional<uint32_t> source_entity;
+		std::string key_prefix;
+
+		/// Sustained rate, in bytes per second.
+		double bytes_per_second = 0;
+		/// Bucket size, in bytes: how much can be sent in a burst after
+		/// a quiet period.
+		size_t burst_bytes = 0;
+
+		OverLimit over_limit = OverLimit::DELAY;
+		std::chrono::milliseconds max_delay{1000};
+	};
+
+	/// @brief Counters of a rule since the shaper was created.
+	struct RuleStats {
+		uint64_t sent_messages = 0;
+		uint64_t sent_bytes = 0;
+		uint64_t delayed = 0;
+		std::chrono::nanoseconds total_delay{0};
+		uint64_t dropped = 0;
+		uint64_t rejected = 0;
+		/// Bytes that can currently be sent without waiting. Negative
+		/// while delayed messages are waiting for their turn, or after a
+		/// message larger than the burst size.
+		double available_bytes = 0;
+		/// Average rate of sent_bytes since the shaper was created.
+		double average_bytes_per_second = 0;
+	};
+
+	enum class Decision { SEND, DROP, REJECT };
+
+	explicit TrafficShaper(const std::vector<Rule>& rules);
+
+	TrafficShaper(const TrafficShaper&) = delete;
+	TrafficShaper& operator=(const TrafficShaper&) = delete;
+	TrafficShaper(TrafficShaper&&) = delete;
+	TrafficShaper& operator=(TrafficShaper&&) = delete;
+
+	/// @brief Charges a message to its rule, waiting first if the rule
+	///        says to delay it.
+	Decision admit(std::string_view zenoh_key, const v1::UMessage& message);
+
+	/// @returns One entry per rule, in the order the rules were given.
+	[[nodiscard]] std::vector<RuleStats> stats() const;
+
+private:
+	struct Bucket {
+		explicit Bucket(const Rule& rule);
+
+		const Rule rule;
+		mutable std::mutex mutex;
+		double tokens;
+		Clock::time_point last_refill;
+		RuleStats stats;
+	};
+
+	[[nodiscard]] Bucket* select_(std::string_view zenoh_key,
+	                              const v1::UAttributes& attributes) const;
+
+	static void refill(Bucket& bucket, Clock::time_point now);
+
+	const Clock::time_point created_;
+	std::vector<std::unique_ptr<Bucket>> buckets_;
+};
+
+}  // namespace uprotocol::transport
+
+#endif  // UP_TRANSPORT_ZENOH_CPP_TRAFFICSHAPER_H
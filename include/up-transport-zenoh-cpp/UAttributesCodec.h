@@ -0,0 +1,69 @@
+// SPDX-FileCopyrightText: 2024 Contributors to the Eclipse Foundation
+//
+// See the NOTICE file(s) distributed with this work for additional
+// information regarding copyright ownership.
+//
+// This program and the accompanying materials are made available under the
+// terms of the Apache License Version 2.0 which is available at
+// https://www.apache.org/licenses/LICENSE-2.0
+//
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef UP_TRANSPORT_ZENOH_CPP_UATTRIBUTESCODEC_H
+#define UP_TRANSPORT_ZENOH_CPP_UATTRIBUTESCODEC_H
+
+#include <uprotocol/v1/uattributes.pb.h>
+
+#include <cstddef>
+#include <cstdint>
+
+namespace uprotocol::transport {
+
+/// @brief Encoder and decoder for the protobuf wire format of UAttributes,
+///        specialized for its fixed schema.
+///
+/// Encoding produces the same bytes as UAttributes::SerializeToArray(), and
+/// decoding accepts and rejects the same inputs as
+/// UAttributes::ParseFromArray(). Unlike protobuf, unknown fields are
+/// skipped when decoding and so are never encoded.
+struct UAttributesCodec {
+	/// @brief Number of bytes encode() writes for these attributes.
+	static size_t encodedSize(const v1::UAttributes& attributes);
+
+	/// @brief Encodes attributes into a caller provided buffer.
+	///
+	/// @param buffer Must have room for at least encodedSize() bytes.
+	///
+	/// @returns A pointer past the last byte written.
+	static uint8_t* encode(const v1::UAttributes& attributes, uint8_t* buffer);
+
+	/// @brief Number of bytes encode() writes before the sink field.
+	///
+	/// Together with encodeSink(), this lets attributes be encoded once
+	/// without a sink, and then for many sinks by inserting each sink at
+	/// this offset.
+	static size_t encodedSizeBeforeSink(const v1::UAttributes& attributes);
+
+	/// @brief Number of bytes encodeSink() writes for this sink.
+	static size_t encodedSinkSize(const v1::UUri& sink);
+
+	/// @brief Encodes the sink field of UAttributes.
+	///
+	/// @returns A pointer past the last byte written.
+	static uint8_t* encodeSink(const v1::UUri& sink, uint8_t* buffer);
+
+	/// @brief Decodes attributes, replacing the contents of attributes.
+	///
+	/// Strings and submessages already allocated in attributes are reused,
+	/// so decoding repeatedly into the same object does not allocate for
+	/// fields that fit.
+	///
+	/// @returns false if data isn't valid UAttributes wire format. The
+	///          contents of attributes are then unspecified.
+	static bool decode(const uint8_t* data, size_t size,
+	                   v1::UAttributes& attributes);
+};
+
+}  // namespace uprotocol::transport
+
+#endif  // UP_TRANSPORT_ZENOH_CPP_UATTRIBUTESCODEC_H
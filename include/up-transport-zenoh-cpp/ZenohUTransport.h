@@ -14,16 +14,219 @@
 
 #include <up-cpp/transport/UTransport.h>
 
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
 #include <filesystem>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
 #include <optional>
+#include <string>
+#include <thread>
+#include <vector>
 
 #define ZENOHCXX_ZENOHC
 #include <zenoh.hxx>
 
-#include "ThreadSafeMap.h"
+#include "BatchSubscription.h"
+#include "DuplicateFilter.h"
+#include "MatchingStatusCache.h"
+#include "PullSubscription.h"
+#include "ReceiveScheduler.h"
+#include "ResponseTable.h"
+#include "SendConflator.h"
+#include "SlowListenerWatchdog.h"
+#include "SubscriberRegistry.h"
+#include "TopicCounters.h"
+#include "TopicLatencies.h"
+#include "TrafficRecorder.h"
+#include "TrafficShaper.h"
 
 namespace uprotocol::transport {
 
+/// @brief Lane for messages with large payloads, so that they don't hold
+///        up small messages of the same priority.
+///
+/// A large message is fragmented and takes time to transmit, and every
+/// message queued behind it in the same zenoh priority lane waits for it.
+/// Large messages are sent on the same session, at a lower zenoh priority.
+/// Messages already at that priority or lower keep their own priority.
+struct LargePayloadLane {
+	/// Payloads of at least this many bytes are large.
+	size_t min_size = size_t{64} * 1024;
+	/// A key sends its small payloads in the normal lane again once it
+	/// hasn't sent a large one for this long. Should be longer than a
+	/// large payload takes to be sent.
+	std::chrono::milliseconds quiet_period{1000};
+	/// Zenoh priority of the lane.
+	zenoh::Priority priority = Z_PRIORITY_BACKGROUND;
+};
+
+/// @brief Optional features of ZenohUTransport. All features are disabled
+///        by default.
+struct ZenohUTransportOptions {
+	/// @brief When set, received messages are dispatched to listeners from
+	///        per-priority queues on scheduler threads instead of directly
+	///        on the zenoh thread.
+	std::optional<ReceiveScheduler::Config> receive_scheduler;
+
+	/// @brief Drop messages whose TTL has elapsed since the time encoded in
+	///        their id, instead of serializing and sending them.
+	bool drop_expired_on_send = false;
+
+	/// @brief Drop received messages whose TTL has elapsed before they are
+	///        decoded any further or passed to a listener.
+	bool drop_expired_on_receive = false;
+
+	/// @brief Return from send() without serializing or sending publish and
+	///        notification messages whose key has no matching subscribers.
+	///
+	/// Each tracked key gets a zenoh publisher of its own, only to watch
+	/// its matching status: messages are still put on the session, as
+	/// their priority can change from one message to the next. This
+	/// doubles the declarations zenoh makes for those keys.
+	///
+	/// Matching status needs zenoh's unstable API. Without it, a warning
+	/// is logged at construction and every message is sent.
+	///
+	/// @see MatchingStatusCache
+	bool skip_unmatched_sends = false;
+
+	/// @brief Maximum number of keys tracked for skip_unmatched_sends.
+	size_t max_matching_status_keys = 1024;
+
+	/// @brief A source topic whose sends are conflated.
+	struct ConflatedTopic {
+		v1::UUri topic;
+		/// Minimum interval between two sends on this topic.
+		std::chrono::milliseconds min_interval;
+	};
+
+	/// @brief Publish topics sent at most once per interval. Messages sent
+	///        faster than that are held, and only the latest held message
+	///        is sent once the interval has passed.
+	///
+	/// @see SendConflator
+	std::vector<ConflatedTopic> conflated_topics;
+
+	/// @brief Publish topics whose latest sent message is kept and served
+	///        to zenoh queries on the topic's key.
+	std::vector<v1::UUri> last_value_topics;
+
+	/// @brief Query for the last value of the topic(s) when a listener
+	///        without a sink filter is registered, and pass any replies to
+	///        that listener.
+	///
+	/// @remarks Replies arrive asynchronously and may race with live
+	///          messages, so a listener can see the last value after a
+	///          newer message.
+	bool fetch_last_value_on_register = false;
+
+	/// @brief Number of zenoh sessions to send messages on.
+	///
+	/// With more than one, each key is mapped to one of the sessions by its
+	/// hash, so messages on a key stay in order while different keys are
+	/// sent in parallel. The additional sessions are opened with the same
+	/// configuration, minus any listen endpoints. Listeners are always
+	/// registered on the first session.
+	size_t send_sessions = 1;
+
+	/// @brief When set, sent and received messages are recorded to this
+	///        capture file, which can be replayed with TrafficReplayer.
+	///
+	/// Messages are recorded as they are passed to send(), and as they are
+	/// passed to listeners or response handlers.
+	///
+	/// @see TrafficRecorder
+	std::optional<std::filesystem::path> record_file;
+
+	/// @brief Maximum size of record_file. Messages that don't fit are
+	///        not recorded.
+	size_t record_capacity = size_t{1} << 30;
+
+	/// @brief Timestamp sent messages, and keep per-topic histograms of
+	///        the latency of received messages.
+	///
+	/// @see ZenohUTransport::getLatencies
+	bool measure_latency = false;
+
+	/// @brief Bandwidth limits on sent messages, by priority, source
+	///        entity or key prefix. Each message is charged to the first
+	///        rule that selects it.
+	///
+	/// Limits apply to messages that are actually put on the session,
+	/// after conflation and unmatched send skipping. A message that is
+	/// dropped or rejected by its rule doesn't become the last value of
+	/// its topic.
+	///
+	/// A DELAY rule that selects conflated topics delays their flushes on
+	/// the conflator's single thread, which holds up the flushes of every
+	/// other conflated topic. Use DROP or REJECT rules for those topics,
+	/// or a min_interval that keeps them within their rule's rate.
+	///
+	/// @see TrafficShaper
+	std::vector<TrafficShaper::Rule> shaping_rules;
+
+	/// @brief Open the zenoh session(s) on a background thread, so that
+	///        the constructor returns as soon as the configuration has
+	///        been loaded.
+	///
+	/// Until the session is open, sends and listener registrations
+	/// (including the response subscriber of invokeMethod()) are queued,
+	/// and return OKSTATUS. They are replayed in order once the session is
+	/// open, and failures at that point are only logged. Pull
+	/// subscriptions can't be created until then.
+	///
+	/// If the session fails to open, queued operations are discarded and
+	/// later ones fail with UNAVAILABLE.
+	///
+	/// @see ZenohUTransport::waitUntilOpen
+	bool open_session_async = false;
+
+	/// @brief Maximum number of operations queued while the session is
+	///        opening. Further operations fail with RESOURCE_EXHAUSTED.
+	size_t max_queued_while_opening = 4096;
+
+	/// @brief When set, each subscriber drops received messages whose id
+	///        it has seen recently, before they are decoded any further or
+	///        passed to a listener.
+	///
+	/// Meant for topologies with redundant routes, where the same sample
+	/// can arrive more than once. Response and pull subscribers are not
+	/// filtered.
+	///
+	/// @see DuplicateFilter
+	std::optional<DuplicateFilter::Config> suppress_duplicates;
+
+	/// @brief When set, each listener call is timed, and calls over the
+	///        threshold are logged, counted and passed to the hook.
+	///
+	/// Listeners are called on the zenoh thread (unless receive_scheduler
+	/// is set), so a slow one holds up every other subscriber of the
+	/// session. With offload set, the later calls of a listener that has
+	/// been slow once are run on a separate thread, in priority order.
+	/// Reports carry the filters the slow listener was registered with.
+	/// Response handlers are not watched.
+	///
+	/// @see ZenohUTransport::getSlowListenerCalls
+	std::optional<SlowListenerConfig> slow_listener_watchdog;
+
+	/// @brief When set, publish and notification messages with large
+	///        payloads are sent in a separate lane.
+	///
+	/// To keep the messages of a key in order, once a key has sent a large
+	/// payload, its later messages are sent in that lane too, until the
+	/// key has been quiet for LargePayloadLane::quiet_period. Earlier
+	/// messages of the key are still sent first, as they are in a higher
+	/// priority lane. RPC messages always stay in the normal lane.
+	///
+	/// @see ZenohUTransport::getBulkLaneSends
+	std::optional<LargePayloadLane> large_payload_lane;
+};
+
 /// @brief Zenoh implementation of UTransport
 ///
 /// This implementation must meet the following requirements:
@@ -51,7 +254,206 @@ struct ZenohUTransport : public UTransport {
 	ZenohUTransport(const v1::UUri& default_uri,
 	                const std::filesystem::path& config_file);
 
-	~ZenohUTransport() override = default;
+	/// @brief Constructor
+	///
+	/// @param default_uri Default Authority and Entity (as a UUri) for
+	///                   clients using this transport instance.
+	/// @param config_file Path to a configuration file containing the Zenoh
+	///                   transport configuration.
+	/// @param options Optional transport features to enable.
+	ZenohUTransport(const v1::UUri& default_uri,
+	                const std::filesystem::path& config_file,
+	                const ZenohUTransportOptions& options);
+
+	~ZenohUTransport() override;
+
+	/// @brief Waits for the session to be open.
+	///
+	/// @returns true if the session is open, false if it failed to open or
+	///          is still opening after timeout.
+	bool waitUntilOpen(std::chrono::milliseconds timeout) const;
+
+	/// @brief Durations of the startup phases, and times to the first
+	///        messages, measured from the start of the constructor.
+	///
+	/// Phases that have not completed yet are 0, and times to the first
+	/// messages are empty until they have happened.
+	struct StartupTimings {
+		/// Loading and parsing the configuration file(s)
+		std::chrono::nanoseconds load_config{0};
+		/// Opening the zenoh session(s), including scouting and
+		/// connecting to peers or routers
+		std::chrono::nanoseconds open_session{0};
+		/// Declaring the queryables and publishers needed by the options
+		std::chrono::nanoseconds declare{0};
+		/// Replaying the operations queued while the session was opening
+		std::chrono::nanoseconds replay{0};
+		/// Until the session was open and all queued operations replayed
+		std::chrono::nanoseconds until_open{0};
+		/// Until the first message was put on the session
+		std::optional<std::chrono::nanoseconds> until_first_send;
+		/// Until the first received message was passed to a listener
+		/// or response handler
+		std::optional<std::chrono::nanoseconds> until_first_delivery;
+	};
+
+	[[nodiscard]] StartupTimings getStartupTimings() const;
+
+	/// @brief Per-topic (zenoh key) counts of messages dropped because
+	///        their TTL had expired.
+	struct ExpiredDrops {
+		TopicCounters::Snapshot on_send;
+		TopicCounters::Snapshot on_receive;
+	};
+
+	[[nodiscard]] ExpiredDrops getExpiredDrops() const;
+
+	/// @brief Per-topic (zenoh key) counts of sends skipped because no
+	///        subscriber matched the key.
+	[[nodiscard]] TopicCounters::Snapshot getUnmatchedSkips() const;
+
+	/// @brief Per-topic (zenoh key) counts of received messages dropped as
+	///        duplicates. Empty unless suppress_duplicates is set.
+	[[nodiscard]] TopicCounters::Snapshot getSuppressedDuplicates() const;
+
+	/// @brief Per-topic (zenoh key) counts of messages sent in the large
+	///        payload lane. Empty unless large_payload_lane is set.
+	[[nodiscard]] TopicCounters::Snapshot getBulkLaneSends() const;
+
+	/// @brief Per-topic (zenoh key) histograms of the durations of slow
+	///        listener calls. Empty unless slow_listener_watchdog is set.
+	[[nodiscard]] TopicLatencies::Snapshot getSlowListenerCalls() const;
+
+	/// @brief Per-topic (zenoh key) counts of messages replaced by a newer
+	///        message on a conflated topic before they were sent.
+	[[nodiscard]] TopicCounters::Snapshot getConflatedSends() const;
+
+	/// @brief Number of messages recorded and dropped by the traffic
+	///        recorder. Both are 0 if record_file isn't set.
+	struct RecordedTraffic {
+		uint64_t recorded;
+		uint64_t dropped;
+	};
+
+	[[nodiscard]] RecordedTraffic getRecordedTraffic() const;
+
+	/// @brief Per-topic (zenoh key) latency histograms of received
+	///        messages. Empty unless measure_latency is set.
+	struct Latencies {
+		/// From the zenoh timestamp set when the message was put, to its
+		/// arrival in this transport. Includes any clock offset between
+		/// the sending and receiving hosts. Messages without a timestamp
+		/// are not counted.
+		TopicLatencies::Snapshot publish_to_delivery;
+		/// From the arrival of a message to the return of each listener
+		/// or response handler it is passed to. Includes any time spent
+		/// queued in the receive scheduler.
+		TopicLatencies::Snapshot delivery_to_callback;
+	};
+
+	[[nodiscard]] Latencies getLatencies() const;
+
+	/// @brief Statistics of each of the shaping_rules, in order.
+	[[nodiscard]] std::vector<TrafficShaper::RuleStats> getShapingStats()
+	    const;
+
+	/// @brief A listener to be registered with registerListeners().
+	struct ListenerRegistration {
+		ListenCallback callback;
+		v1::UUri source_filter;
+		std::optional<v1::UUri> sink_filter;
+	};
+
+	using RegistrationResult = utils::Expected<ListenHandle, v1::UStatus>;
+
+	/// @brief Register many listeners at once.
+	///
+	/// Equivalent to calling registerListener() for each entry, but faster
+	/// for large numbers of listeners: each key is computed once, listeners
+	/// on identical keys share a single subscriber, subscribers are
+	/// declared in parallel when there are enough of them (at least 128)
+	/// and all are added to the registry under a single lock.
+	///
+	/// @returns One result per registration, in the same order. Each is
+	///          either a connected ListenHandle or the UStatus explaining
+	///          why that registration failed.
+	[[nodiscard]] std::vector<RegistrationResult> registerListeners(
+	    std::vector<ListenerRegistration>&& registrations);
+
+	/// @brief Send an RPC request and pass its response straight to a
+	///        handler.
+	///
+	/// Responses are received through a single subscriber per requesting
+	/// entity (the request's source), and matched to their handler by
+	/// request id in a ResponseTable. This keeps the cost of each call
+	/// independent of the number of calls in flight. The subscriber is
+	/// undeclared once the requester has no calls left in flight.
+	///
+	/// Only a response from the request's sink is passed to the handler.
+	/// Expired responses are skipped if drop_expired_on_receive is set.
+	///
+	/// @param request A request message with a TTL.
+	/// @param handler Called once, with either the response or a
+	///                DEADLINE_EXCEEDED status if no response arrived
+	///                within the request's TTL. Not called if sending the
+	///                request fails.
+	///
+	/// @returns * OKSTATUS if the request was sent.
+	///          * FAILSTATUS with the appropriate failure otherwise.
+	[[nodiscard]] v1::UStatus invokeMethod(const v1::UMessage& request,
+	                                       ResponseTable::Handler&& handler);
+
+	/// @brief Send the same notification to many sinks.
+	///
+	/// Equivalent to sending a copy of notification to each sink, but the
+	/// payload is serialized once and shared by all puts, the attributes
+	/// are encoded once with only the sink inserted per put, and the
+	/// source part of the key is built once.
+	///
+	/// @param notification A notification. Its sink is ignored.
+	///
+	/// @returns One status per sink, in the same order, as send() would
+	///          have returned for that sink.
+	[[nodiscard]] std::vector<v1::UStatus> sendToSinks(
+	    const v1::UMessage& notification, const std::vector<v1::UUri>& sinks);
+
+	using PullSubscriptionResult =
+	    utils::Expected<std::unique_ptr<PullSubscription>, v1::UStatus>;
+
+	/// @brief Subscribe to messages matching the filters, to be pulled
+	///        from a queue instead of passed to a listener.
+	///
+	/// Messages are matched exactly as for registerListener(). Expired
+	/// messages are skipped if drop_expired_on_receive is set. Received
+	/// messages are not recorded or measured.
+	///
+	/// @returns * A PullSubscription, which stays subscribed until it is
+	///            destroyed.
+	///          * FAILSTATUS with the appropriate failure otherwise.
+	[[nodiscard]] PullSubscriptionResult createPullSubscription(
+	    const v1::UUri& source_filter,
+	    const std::optional<v1::UUri>& sink_filter,
+	    const PullSubscription::Config& config);
+
+	using BatchSubscriptionResult =
+	    utils::Expected<std::unique_ptr<BatchSubscription>, v1::UStatus>;
+
+	/// @brief Subscribe to messages matching the filters, to be passed to
+	///        a callback in batches.
+	///
+	/// For listeners receiving at high rates, which can then spread the
+	/// cost of locking and processing over a batch. Messages are matched
+	/// and filtered as for createPullSubscription(), and are not recorded
+	/// or measured either.
+	///
+	/// @returns * A BatchSubscription, which stays subscribed until it is
+	///            destroyed.
+	///          * FAILSTATUS with the appropriate failure otherwise.
+	[[nodiscard]] BatchSubscriptionResult createBatchSubscription(
+	    const v1::UUri& source_filter,
+	    const std::optional<v1::UUri>& sink_filter,
+	    const BatchSubscription::Config& config,
+	    BatchSubscription::Callback&& callback);
 
 protected:
 	/// @brief Send a message.
@@ -96,32 +498,233 @@ protected:
 	    const std::string& default_authority_name, const v1::UUri& source,
 	    const std::optional<v1::UUri>& sink);
 
+	/// @brief Index of the session that sends messages on a key, out of
+	///        num_sessions, 0 being the session listeners are on.
+	///
+	/// Depends only on the key, so that all messages on a key are sent in
+	/// order by the same session, whatever their priority.
+	static size_t sendSessionIndex(const std::string& zenoh_key,
+	                               size_t num_sessions);
+
+	/// @brief Checks if a message's TTL has elapsed at the given time.
+	///
+	/// The creation time of a message is the timestamp in its (UUIDv7) id.
+	/// Messages without a TTL, or with a TTL of 0, never expire.
+	static bool isExpired(const v1::UAttributes& attributes,
+	                      std::chrono::system_clock::time_point now =
+	                          std::chrono::system_clock::now());
+
 private:
 	static v1::UStatus uError(v1::UCode code, std::string_view message);
 
+	void openSession_(zenoh::Config&& config,
+	                  std::vector<zenoh::Config>&& send_configs);
+
+	/// Runs an operation now if the session is open, or queues it to run
+	/// once the session is open. An operation queued for a listener is
+	/// discarded if the listener is cleaned up before it runs.
+	v1::UStatus runWhenOpen_(
+	    std::function<v1::UStatus()>&& operation,
+	    std::optional<CallableConn> listener = std::nullopt);
+
+	/// Moves out of OPENING into FAILED, discarding queued operations.
+	void failOpen_(std::string_view reason);
+
+	[[nodiscard]] bool isOpen_() const {
+		return startup_state_.load(std::memory_order_acquire) ==
+		       StartupState::OPEN;
+	}
+
+	void noteFirst_(std::atomic<int64_t>& first_ns) const;
+
+	v1::UStatus conflateAndSend_(const v1::UMessage& message);
+
 	static std::vector<std::pair<std::string, std::vector<uint8_t>>>
 	uattributesToAttachment(const v1::UAttributes& attributes);
 
-	static v1::UAttributes attachmentToUAttributes(
-	    const zenoh::Bytes& attachment);
+	/// Decodes the attributes straight from the attachment bytes into
+	/// attributes (usually those of the message being received), reusing
+	/// what is already allocated there.
+	///
+	/// Returns false if the attachment isn't valid.
+	static bool attachmentToUAttributes(const zenoh::Bytes& attachment,
+	                                    v1::UAttributes& attributes);
 
 	static zenoh::Priority mapZenohPriority(v1::UPriority upriority);
 
-	static std::optional<v1::UMessage> sampleToUMessage(
-	    const zenoh::Sample& sample);
+	static bool sampleToUAttributes(const zenoh::Sample& sample,
+	                                v1::UAttributes& attributes);
+	static void samplePayloadToUMessage(const zenoh::Sample& sample,
+	                                    v1::UMessage& message);
 	static std::optional<v1::UMessage> queryToUMessage(
 	    const zenoh::Query& query);
 
+	using Registry = SubscriberRegistry<CallableConn, zenoh::Subscriber<void>>;
+
+	zenoh::Subscriber<void> declareSubscriber_(
+	    const std::string& zenoh_key,
+	    std::shared_ptr<Registry::ListenerSet> listeners);
+
 	v1::UStatus registerPublishNotificationListener_(
 	    const std::string& zenoh_key, CallableConn listener);
 
+	void handleSample_(const zenoh::Sample& sample,
+	                   const Registry::ListenerSet& listener_set,
+	                   DuplicateFilter* duplicates);
+
+	/// Calls a listener, timed by the watchdog if there is one. Delivery
+	/// is noted once the listener returns, which for an offloaded call is
+	/// on the offload thread.
+	void invokeListener_(CallableConn& listener, const v1::UMessage& message,
+	                     std::string_view zenoh_key,
+	                     std::chrono::steady_clock::time_point delivered);
+
+	/// Notes the delivery of a message received at delivered.
+	void noteDelivered_(std::string_view zenoh_key,
+	                    std::chrono::steady_clock::time_point delivered);
+
+	/// Zenoh key of the subscriber receiving responses for a requester.
+	std::string responseKey_(const v1::UUri& requester);
+
+	/// Declares the response subscriber on zenoh_key, unless it already
+	/// exists or has no calls left in flight.
+	v1::UStatus declareResponseSubscriber_(const std::string& zenoh_key);
+
+	/// Ends a call in flight on zenoh_key, undeclaring the response
+	/// subscriber if it was the last one.
+	void releaseResponseSubscriber_(const std::string& zenoh_key);
+
+	void handleResponse_(const zenoh::Sample& sample);
+
+	void measurePublishToDelivery_(const zenoh::Sample& sample);
+
+	/// Returns a status if a subscription with these filters and capacity
+	/// can't be created.
+	std::optional<v1::UStatus> checkSubscription_(
+	    const v1::UUri& source_filter,
+	    const std::optional<v1::UUri>& sink_filter, size_t capacity) const;
+
+	PullSubscription::Decoder subscriptionDecoder_() const;
+
+	void fetchLastValue_(const std::string& zenoh_key, CallableConn listener);
+
+	void declareLastValueQueryables_();
+
+	v1::UStatus sendKeyed_(const std::string& zenoh_key,
+	                       const v1::UMessage& message);
+
+	zenoh::Session& sendSessionFor_(const std::string& zenoh_key);
+
+	/// Checks if nobody would receive a message sent on zenoh_key.
+	bool isUnmatched_(const std::string& zenoh_key, v1::UMessageType type);
+
+	/// Returns a status if traffic shaping says the message must not be
+	/// put on zenoh_key.
+	std::optional<v1::UStatus> shape_(const std::string& zenoh_key,
+	                                  const v1::UMessage& message);
+
 	v1::UStatus sendPublishNotification_(const std::string& zenoh_key,
 	                                     const std::string& payload,
 	                                     const v1::UAttributes& attributes);
 
-	zenoh::Session session_;
+	/// Whether a message goes in the large payload lane.
+	bool isBulk_(const std::string& zenoh_key, size_t payload_size,
+	             v1::UMessageType type);
+
+	v1::UStatus put_(const std::string& zenoh_key, zenoh::Bytes&& payload,
+	                 zenoh::Bytes&& attachment, zenoh::Priority priority,
+	                 bool bulk);
+
+	const ZenohUTransportOptions options_;
+
+	const std::chrono::steady_clock::time_point construction_start_;
+
+	enum class StartupState { OPENING, OPEN, FAILED };
+	std::atomic<StartupState> startup_state_ = StartupState::OPENING;
+	// Protects startup_queue_ and startup_timings_, and the transitions
+	// out of OPENING
+	mutable std::mutex startup_mutex_;
+	mutable std::condition_variable startup_cv_;
+	struct QueuedOperation {
+		std::function<void()> run;
+		// The listener this operation registers, if any
+		std::optional<CallableConn> listener;
+	};
+	std::deque<QueuedOperation> startup_queue_;
+	StartupTimings startup_timings_;
+	std::atomic<int64_t> first_send_ns_ = 0;
+	std::atomic<int64_t> first_delivery_ns_ = 0;
+	// Joined by the destructor, before any other member is destroyed
+	std::thread startup_thread_;
+
+	// NOTE: Declared before the sessions so that it outlives any callback
+	// recording to it.
+	std::unique_ptr<TrafficRecorder> recorder_;
+
+	// Set once, before the startup state becomes OPEN
+	std::optional<zenoh::Session> session_;
+	// Sessions used for sending in addition to session_
+	std::vector<zenoh::Session> send_sessions_;
+
+	// Keys in the large payload lane, with the time each last sent a large
+	// payload. Quiet keys are swept whenever the map has doubled.
+	std::map<std::string, std::chrono::steady_clock::time_point, std::less<>>
+	    bulk_keys_;
+	size_t bulk_keys_sweep_size_ = 64;
+	// Size of bulk_keys_, read without the lock
+	std::atomic<size_t> num_bulk_keys_ = 0;
+	std::mutex bulk_keys_mutex_;
+
+	TopicCounters expired_on_send_;
+	TopicCounters expired_on_receive_;
+	TopicCounters unmatched_skips_;
+	TopicCounters duplicates_on_receive_;
+	TopicCounters bulk_lane_sends_;
+
+	TopicLatencies publish_to_delivery_;
+	TopicLatencies delivery_to_callback_;
+
+	std::unique_ptr<MatchingStatusCache> matching_status_;
+
+	using ListenerWatchdog = SlowListenerWatchdog<CallableConn>;
+	std::unique_ptr<ListenerWatchdog> listener_watchdog_;
+	// Runs the calls of listeners the watchdog found to be slow
+	std::unique_ptr<ReceiveScheduler> offload_executor_;
+
+	// NOTE: Tasks use the watchdog and post to the offload executor, so
+	// the scheduler must be declared after them to be stopped first.
+	std::unique_ptr<ReceiveScheduler> receive_scheduler_;
+
+	// Latest message per last value topic key. The set of keys is fixed at
+	// construction.
+	struct LastValue {
+		std::mutex mutex;
+		std::shared_ptr<const v1::UMessage> message;
+	};
+	std::map<std::string, LastValue> last_values_;
+	std::vector<zenoh::Queryable<void>> last_value_queryables_;
+
+	std::unique_ptr<TrafficShaper> traffic_shaper_;
+
+	// NOTE: Flushes use the members above, so the conflator must be
+	// declared after them to be stopped first.
+	std::unique_ptr<SendConflator> send_conflator_;
+
+	struct ResponseSubscriber {
+		size_t in_flight = 0;
+		std::optional<zenoh::Subscriber<void>> subscriber;
+	};
+
+	// NOTE: Expired handlers release their subscriber from the table's
+	// thread, so the subscribers must outlive the table. They are
+	// undeclared explicitly by the destructor instead.
+	std::map<std::string, ResponseSubscriber> response_subscribers_;
+	std::mutex response_subscribers_mutex_;
+	ResponseTable response_table_;
 
-	ThreadSafeMap<CallableConn, zenoh::Subscriber<void>> subscriber_map_;
+	// NOTE: Subscriber callbacks use the members above, so the registry
+	// must be declared last for the subscribers to be undeclared first.
+	Registry subscriber_registry_;
 };
 
 }  // namespace uprotocol::transport
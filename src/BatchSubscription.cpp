@@ -0,0 +1,103 @@
+// SPDX-FileCopyrightText: 2024 Contributors to the Eclipse Foundation
+//
+// See the NOTICE file(s) distributed with this work for additional
+// information regarding copyright ownership.
+//
+// This program and the accompanying materials are made available under the
+// terms of the Apache License Version 2.0 which is available at
+// https://www.apache.org/licenses/LICENSE-2.0
+//
+// SPDX-License-Identifier: Apache-2.0
+
+#include "up-transport-zenoh-cpp/BatchSubscription.h"
+
+#include <spdlog/spdlog.h>
+
+namespace uprotocol::transport {
+
+BatchSubscription::BatchSubscription(const zenoh::Session& session,
+                                     const std::string& zenoh_key,
+                                     const Config& config, Decoder decoder,
+                                     Callback callback)
+    : config_(config),
+      decoder_(std::move(decoder)),
+      callback_(std::move(callback)) {
+	pending_.reserve(config_.max_batch);
+	subscriber_.emplace(session.declare_subscriber(
+	    zenoh::KeyExpr(zenoh_key),
+	    [this](const zenoh::Sample& sample) { onSample_(sample); },
+	    []() {}));
+	// Samples arriving before the thread starts just wait in pending_
+	deliverer_ = std::thread([this]() { run_(); });
+}
+
+BatchSubscription::~BatchSubscription() {
+	subscriber_.reset();
+	{
+		std::lock_guard<std::mutex> lock(mutex_);
+		stop_ = true;
+	}
+	cv_.notify_one();
+	deliverer_.join();
+}
+
+void BatchSubscription::onSample_(const zenoh::Sample& sample) {
+	auto message = decoder_(sample);
+	if (!message.has_value()) {
+		return;
+	}
+
+	std::lock_guard<std::mutex> lock(mutex_);
+	if (pending_.size() >= config_.capacity) {
+		++dropped_;
+		return;
+	}
+	pending_.push_back(std::move(*message));
+	// The deliverer waits without a deadline while nothing is pending
+	if (pending_.size() == 1) {
+		pending_since_ = Clock::now();
+		cv_.notify_one();
+	} else if (pending_.size() == config_.max_batch) {
+		cv_.notify_one();
+	}
+}
+
+void BatchSubscription::run_() {
+	// Swapped with pending_ for each delivery, so that both keep their
+	// capacity
+	std::vector<v1::UMessage> batch;
+	batch.reserve(config_.max_batch);
+
+	std::unique_lock<std::mutex> lock(mutex_);
+	while (true) {
+		if (pending_.empty()) {
+			if (stop_) {
+				return;
+			}
+			cv_.wait(lock);
+			continue;
+		}
+
+		const bool full = pending_.size() >= config_.max_batch;
+		if (!full && !stop_) {
+			const auto deadline = pending_since_ + config_.max_delay;
+			if (Clock::now() < deadline) {
+				cv_.wait_until(lock, deadline);
+				continue;
+			}
+		}
+
+		batch.swap(pending_);
+		lock.unlock();
+		try {
+			callback_(batch);
+		} catch (const std::exception& e) {
+			spdlog::error("BatchSubscription: callback threw exception: {}",
+			              e.what());
+		}
+		batch.clear();
+		lock.lock();
+	}
+}
+
+}  // namespace uprotocol::transport
@@ -0,0 +1,90 @@
+// SPDX-FileCopyrightText: 2024 Contributors to the Eclipse Foundation
+//
+// See the NOTICE file(s) distributed with this work for additional
+// information regarding copyright ownership.
+//
+// This program and the accompanying materials are made available under the
+// terms of the Apache License Version 2.0 which is available at
+// https://www.apache.org/licenses/LICENSE-2.0
+//
+// SPDX-License-Identifier: Apache-2.0
+
+#include "up-transport-zenoh-cpp/DuplicateFilter.h"
+
+#include <algorithm>
+
+namespace uprotocol::transport {
+
+namespace {
+
+// Slots looked at for each id. An id that finds none of them free evicts
+// the oldest.
+constexpr size_t MAX_PROBES = 8;
+
+uint64_t hashId(uint64_t msb, uint64_t lsb) {
+	// Finalizer of splitmix64, as the random bits of a UUIDv7 are not
+	// spread evenly over both halves
+	constexpr uint64_t MUL1 = 0xBF58476D1CE4E5B9ULL;
+	constexpr uint64_t MUL2 = 0x94D049BB133111EBULL;
+	uint64_t hash = msb ^ ((lsb << 32U) | (lsb >> 32U));
+	hash = (hash ^ (hash >> 30U)) * MUL1;
+	hash = (hash ^ (hash >> 27U)) * MUL2;
+	return hash ^ (hash >> 31U);
+}
+
+}  // namespace
+
+DuplicateFilter::DuplicateFilter(const Config& config)
+    : window_(config.window),
+      num_shards_(std::max<size_t>(config.shards, 1)),
+      shards_(std::make_unique<Shard[]>(num_shards_)) {  // NOLINT
+	const size_t slots_per_shard =
+	    std::max<size_t>((config.capacity + num_shards_ - 1) / num_shards_, 1);
+	for (size_t shard = 0; shard < num_shards_; ++shard) {
+		shards_[shard].slots.resize(slots_per_shard);
+	}
+}
+
+bool DuplicateFilter::isDuplicate(const v1::UUID& id, Clock::time_point now) {
+	const uint64_t msb = id.msb();
+	const uint64_t lsb = id.lsb();
+	if ((msb == 0) && (lsb == 0)) {
+		return false;
+	}
+
+	const uint64_t hash = hashId(msb, lsb);
+	auto& shard = shards_[hash % num_shards_];
+	auto& slots = shard.slots;
+	const size_t start = static_cast<size_t>(hash / num_shards_) % slots.size();
+	const size_t probes = std::min(MAX_PROBES, slots.size());
+
+	std::lock_guard<std::mutex> lock(shard.mutex);
+	Slot* free_slot = nullptr;
+	Slot* oldest_slot = nullptr;
+	for (size_t probe = 0; probe < probes; ++probe) {
+		auto& slot = slots[(start + probe) % slots.size()];
+		const bool live = ((slot.msb != 0) || (slot.lsb != 0)) &&
+		                  ((now - slot.seen) < window_);
+		if (!live) {
+			if (free_slot == nullptr) {
+				free_slot = &slot;
+			}
+			continue;
+		}
+		if ((slot.msb == msb) && (slot.lsb == lsb)) {
+			++suppressed_;
+			return true;
+		}
+		if ((oldest_slot == nullptr) || (slot.seen < oldest_slot->seen)) {
+			oldest_slot = &slot;
+		}
+	}
+
+	Slot& slot = (free_slot != nullptr) ? *free_slot : *oldest_slot;
+	slot.msb = msb;
+	slot.lsb = lsb;
+	slot.seen = now;
+	return false;
+}
+
+}  // namespace uprotocol::transport
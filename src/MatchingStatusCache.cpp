@@ -0,0 +1,88 @@
+// SPDX-FileCopyrightText: 2024 Contributors to the Eclipse Foundation
+//
+// See the NOTICE file(s) distributed with this work for additional
+// information regarding copyright ownership.
+//
+// This program and the accompanying materials are made available under the
+// terms of the Apache License Version 2.0 which is available at
+// https://www.apache.org/licenses/LICENSE-2.0
+//
+// SPDX-License-Identifier: Apache-2.0
+
+#include "up-transport-zenoh-cpp/MatchingStatusCache.h"
+
+#include <spdlog/spdlog.h>
+
+namespace uprotocol::transport {
+
+MatchingStatusCache::MatchingStatusCache(const zenoh::Session& session,
+                                         size_t capacity)
+    : session_(session), capacity_(capacity) {
+	if (!isSupported()) {
+		spdlog::warn(
+		    "MatchingStatusCache: zenoh was built without matching status "
+		    "support, all keys will be treated as having subscribers");
+	}
+}
+
+bool MatchingStatusCache::hasSubscribers(const std::string& zenoh_key) {
+	if (!isSupported()) {
+		return true;
+	}
+
+	{
+		std::shared_lock<std::shared_mutex> lock(mutex_);
+		auto it = entries_.find(zenoh_key);
+		if (it != entries_.end()) {
+			return it->second.matching->load(std::memory_order_relaxed);
+		}
+		if (entries_.size() >= capacity_) {
+			return true;
+		}
+	}
+
+	// Declaring the publisher takes a round trip through zenoh, so it is
+	// done without holding the lock. If another sender tracked the key
+	// meanwhile, this entry is dropped and the existing one is used.
+	auto entry = track_(zenoh_key);
+	if (!entry.has_value()) {
+		return true;
+	}
+	std::unique_lock<std::shared_mutex> lock(mutex_);
+	if (entries_.size() >= capacity_) {
+		return true;
+	}
+	auto it = entries_.try_emplace(zenoh_key, std::move(*entry)).first;
+	return it->second.matching->load(std::memory_order_relaxed);
+}
+
+std::optional<MatchingStatusCache::Entry> MatchingStatusCache::track_(
+    const std::string& zenoh_key) const {
+#if defined(Z_FEATURE_UNSTABLE_API)
+	try {
+		auto publisher = session_.declare_publisher(zenoh::KeyExpr(zenoh_key));
+		auto matching = std::make_shared<std::atomic<bool>>(
+		    publisher.get_matching_status().matching);
+		publisher.declare_background_matching_listener(
+		    [matching](const zenoh::MatchingStatus& status) {
+			    matching->store(status.matching, std::memory_order_relaxed);
+		    },
+		    []() {});
+		return Entry{std::move(publisher), std::move(matching)};
+	} catch (const zenoh::ZException& e) {
+		spdlog::warn(
+		    "MatchingStatusCache: cannot track matching status for {}: {}",
+		    zenoh_key, e.what());
+	}
+#else
+	(void)zenoh_key;
+#endif
+	return std::nullopt;
+}
+
+size_t MatchingStatusCache::size() const {
+	std::shared_lock<std::shared_mutex> lock(mutex_);
+	return entries_.size();
+}
+
+}  // namespace uprotocol::transport
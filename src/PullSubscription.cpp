@@ -0,0 +1,122 @@
+// SPDX-FileCopyrightText: 2024 Contributors to the Eclipse Foundation
+//
+// See the NOTICE file(s) distributed with this work for additional
+// information regarding copyright ownership.
+//
+// This program and the accompanying materials are made available under the
+// terms of the Apache License Version 2.0 which is available at
+// https://www.apache.org/licenses/LICENSE-2.0
+//
+// SPDX-License-Identifier: Apache-2.0
+
+#include "up-transport-zenoh-cpp/PullSubscription.h"
+
+#include <algorithm>
+#include <thread>
+
+namespace uprotocol::transport {
+
+namespace {
+
+// Bounds of the interval between polls of the channel while waiting
+constexpr auto MIN_POLL_INTERVAL = std::chrono::microseconds(50);
+constexpr auto MAX_POLL_INTERVAL = std::chrono::microseconds(1000);
+
+}  // namespace
+
+PullSubscription::PullSubscription(const zenoh::Session& session,
+                                   const std::string& zenoh_key,
+                                   const Config& config, Decoder decoder)
+    : decoder_(std::move(decoder)),
+      subscriber_(declare_(session, zenoh_key, config)) {}
+
+PullSubscription::AnySubscriber PullSubscription::declare_(
+    const zenoh::Session& session, const std::string& zenoh_key,
+    const Config& config) {
+	switch (config.overflow) {
+		case OverflowPolicy::BLOCK:
+			return session.declare_subscriber(
+			    zenoh::KeyExpr(zenoh_key),
+			    zenoh::channels::FifoChannel(config.capacity));
+		case OverflowPolicy::DROP_OLDEST:
+		default:
+			return session.declare_subscriber(
+			    zenoh::KeyExpr(zenoh_key),
+			    zenoh::channels::RingChannel(config.capacity));
+	}
+}
+
+std::optional<zenoh::Sample> PullSubscription::takeSample_(
+    std::optional<std::chrono::steady_clock::time_point> deadline) {
+	using std::chrono::steady_clock;
+	auto poll_interval =
+	    std::chrono::duration_cast<steady_clock::duration>(MIN_POLL_INTERVAL);
+	while (true) {
+		auto result = std::visit(
+		    [](const auto& subscriber) {
+			    return subscriber.handler().try_recv();
+		    },
+		    subscriber_);
+		if (auto* sample = std::get_if<zenoh::Sample>(&result)) {
+			return std::move(*sample);
+		}
+		if ((std::get<zenoh::channels::RecvError>(result) ==
+		     zenoh::channels::RecvError::Z_DISCONNECTED) ||
+		    !deadline.has_value()) {
+			return std::nullopt;
+		}
+
+		const auto now = steady_clock::now();
+		if (now >= *deadline) {
+			return std::nullopt;
+		}
+		std::this_thread::sleep_for(std::min(poll_interval, *deadline - now));
+		poll_interval = std::min(
+		    2 * poll_interval,
+		    std::chrono::duration_cast<steady_clock::duration>(
+		        MAX_POLL_INTERVAL));
+	}
+}
+
+std::optional<v1::UMessage> PullSubscription::tryReceive() {
+	// Skipped samples don't count as received, so keep going until a
+	// message is decoded or the queue is empty.
+	while (auto sample = takeSample_(std::nullopt)) {
+		auto message = decoder_(*sample);
+		if (message.has_value()) {
+			return message;
+		}
+	}
+	return std::nullopt;
+}
+
+std::optional<v1::UMessage> PullSubscription::receive(
+    std::chrono::milliseconds timeout) {
+	const auto deadline = std::chrono::steady_clock::now() + timeout;
+	while (auto sample = takeSample_(deadline)) {
+		auto message = decoder_(*sample);
+		if (message.has_value()) {
+			return message;
+		}
+	}
+	return std::nullopt;
+}
+
+size_t PullSubscription::drain(std::vector<v1::UMessage>& messages,
+                               size_t max_messages) {
+	size_t drained = 0;
+	while (drained < max_messages) {
+		auto sample = takeSample_(std::nullopt);
+		if (!sample.has_value()) {
+			break;
+		}
+		auto message = decoder_(*sample);
+		if (message.has_value()) {
+			messages.push_back(std::move(*message));
+			++drained;
+		}
+	}
+	return drained;
+}
+
+}  // namespace uprotocol::transport
@@ -0,0 +1,161 @@
+// SPDX-FileCopyrightText: 2024 Contributors to the Eclipse Foundation
+//
+// See the NOTICE file(s) distributed with this work for additional
+// information regarding copyright ownership.
+//
+// This program and the accompanying materials are made available under the
+// terms of the Apache License Version 2.0 which is available at
+// https://www.apache.org/licenses/LICENSE-2.0
+//
+// SPDX-License-Identifier: Apache-2.0
+
+#include "up-transport-zenoh-cpp/ReceiveScheduler.h"
+
+#include <spdlog/spdlog.h>
+
+#include <algorithm>
+
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+namespace uprotocol::transport {
+
+ReceiveScheduler::ReceiveScheduler(const Config& config) : config_(config) {
+	normal_lane_.worker = std::thread([this]() { run(normal_lane_); });
+
+	if (config_.dedicated_high_priority_lane) {
+		high_lane_ = std::make_unique<Lane>();
+		high_lane_->worker = std::thread([this]() { run(*high_lane_); });
+
+		if (config_.high_priority_cpu.has_value()) {
+#ifdef __linux__
+			cpu_set_t cpu_set;
+			CPU_ZERO(&cpu_set);
+			CPU_SET(*config_.high_priority_cpu, &cpu_set);
+			const int result =
+			    pthread_setaffinity_np(high_lane_->worker.native_handle(),
+			                           sizeof(cpu_set), &cpu_set);
+			if (result != 0) {
+				spdlog::warn(
+				    "ReceiveScheduler: failed to pin high priority lane to "
+				    "CPU {}: error {}",
+				    *config_.high_priority_cpu, result);
+			}
+#else
+			spdlog::warn(
+			    "ReceiveScheduler: thread pinning is not supported on this "
+			    "platform");
+#endif
+		}
+	}
+}
+
+ReceiveScheduler::~ReceiveScheduler() {
+	if (high_lane_) {
+		stop(*high_lane_);
+	}
+	stop(normal_lane_);
+}
+
+size_t ReceiveScheduler::priorityIndex(v1::UPriority priority) {
+	if ((priority < v1::UPriority::UPRIORITY_CS0) ||
+	    (priority > v1::UPriority::UPRIORITY_CS6)) {
+		// Unspecified priorities are sent as CS1 (see mapZenohPriority)
+		return static_cast<size_t>(v1::UPriority::UPRIORITY_CS1);
+	}
+	return static_cast<size_t>(priority);
+}
+
+bool ReceiveScheduler::post(v1::UPriority priority, Task&& task) {
+	const size_t index = priorityIndex(priority);
+	const bool is_high_priority =
+	    high_lane_ &&
+	    (index >= priorityIndex(config_.high_priority_threshold));
+	Lane& lane = is_high_priority ? *high_lane_ : normal_lane_;
+	{
+		std::lock_guard<std::mutex> lock(lane.mutex);
+		auto& queue = lane.queues[index];
+		if (queue.size() >= config_.queue_capacity) {
+			++dropped_;
+			return false;
+		}
+		queue.emplace_back(std::move(task));
+	}
+	lane.cv.notify_one();
+	return true;
+}
+
+std::optional<ReceiveScheduler::Task> ReceiveScheduler::next(Lane& lane) {
+	auto take = [&lane](size_t index) {
+		Task task = std::move(lane.queues[index].front());
+		lane.queues[index].pop_front();
+		return task;
+	};
+
+	if (config_.policy == Policy::STRICT_PRIORITY) {
+		for (size_t index = NUM_PRIORITIES; index-- > 0;) {
+			if (!lane.queues[index].empty()) {
+				return take(index);
+			}
+		}
+		return std::nullopt;
+	}
+
+	// Weighted: each priority may run up to its weight in tasks per round,
+	// higher priorities first. A new round starts once every non-empty
+	// queue has used up its credits.
+	for (int round = 0; round < 2; ++round) {
+		for (size_t index = NUM_PRIORITIES; index-- > 0;) {
+			if (!lane.queues[index].empty() && (lane.credits[index] > 0)) {
+				--lane.credits[index];
+				return take(index);
+			}
+		}
+		for (size_t index = 0; index < NUM_PRIORITIES; ++index) {
+			lane.credits[index] =
+			    std::max<uint32_t>(config_.weights[index], 1);
+		}
+	}
+	return std::nullopt;
+}
+
+void ReceiveScheduler::run(Lane& lane) {
+	std::unique_lock<std::mutex> lock(lane.mutex);
+	while (true) {
+		auto task = next(lane);
+		if (!task.has_value()) {
+			if (lane.stop) {
+				break;
+			}
+			lane.cv.wait(lock);
+			continue;
+		}
+
+		lock.unlock();
+		try {
+			(*task)();
+		} catch (const std::exception& e) {
+			spdlog::error("ReceiveScheduler: listener threw exception: {}",
+			              e.what());
+		}
+		lock.lock();
+	}
+}
+
+void ReceiveScheduler::stop(Lane& lane) {
+	{
+		std::lock_guard<std::mutex> lock(lane.mutex);
+		lane.stop = true;
+		for (auto& queue : lane.queues) {
+			queue.clear();
+		}
+	}
+	lane.cv.notify_all();
+	if (lane.worker.joinable()) {
+		lane.worker.join();
+	}
+}
+
+}  // namespace uprotocol::transport
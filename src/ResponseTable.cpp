@@ -0,0 +1,136 @@
+// SPDX-FileCopyrightText: 2024 Contributors to the Eclipse Foundation
+//
+// See the NOTICE file(s) distributed with this work for additional
+// information regarding copyright ownership.
+//
+// This program and the accompanying materials are made available under the
+// terms of the Apache License Version 2.0 which is available at
+// https://www.apache.org/licenses/LICENSE-2.0
+//
+// SPDX-License-Identifier: Apache-2.0
+
+#include "up-transport-zenoh-cpp/ResponseTable.h"
+
+#include <spdlog/spdlog.h>
+
+namespace uprotocol::transport {
+
+namespace {
+
+bool sameUri(const v1::UUri& lhs, const v1::UUri& rhs) {
+	return (lhs.ue_id() == rhs.ue_id()) &&
+	       (lhs.ue_version_major() == rhs.ue_version_major()) &&
+	       (lhs.resource_id() == rhs.resource_id()) &&
+	       (lhs.authority_name() == rhs.authority_name());
+}
+
+}  // namespace
+
+ResponseTable::ResponseTable() {
+	expiry_thread_ = std::thread([this]() { expire(); });
+}
+
+ResponseTable::~ResponseTable() {
+	{
+		std::lock_guard<std::mutex> lock(deadlines_mutex_);
+		stop_ = true;
+	}
+	deadlines_cv_.notify_all();
+	expiry_thread_.join();
+}
+
+bool ResponseTable::expect(const v1::UUID& reqid, const v1::UUri& responder,
+                           std::chrono::milliseconds ttl, Handler&& handler) {
+	const auto key = toKey(reqid);
+	{
+		auto& shard = shardFor(key);
+		std::lock_guard<std::mutex> lock(shard.mutex);
+		if (!shard.handlers.emplace(key, Waiter{std::move(handler), responder})
+		         .second) {
+			return false;
+		}
+	}
+
+	const Deadline deadline{Clock::now() + ttl, key};
+	bool earliest = false;
+	{
+		std::lock_guard<std::mutex> lock(deadlines_mutex_);
+		earliest =
+		    deadlines_.empty() || (deadline.when < deadlines_.top().when);
+		deadlines_.push(deadline);
+	}
+	if (earliest) {
+		deadlines_cv_.notify_one();
+	}
+	return true;
+}
+
+std::optional<ResponseTable::Handler> ResponseTable::take(
+    const v1::UUID& reqid, const v1::UUri& source) {
+	return take(toKey(reqid), &source);
+}
+
+std::optional<ResponseTable::Handler> ResponseTable::take(
+    const v1::UUID& reqid) {
+	return take(toKey(reqid), nullptr);
+}
+
+std::optional<ResponseTable::Handler> ResponseTable::take(
+    const Key& key, const v1::UUri* source) {
+	auto& shard = shardFor(key);
+	std::lock_guard<std::mutex> lock(shard.mutex);
+	auto it = shard.handlers.find(key);
+	if (it == shard.handlers.end()) {
+		return std::nullopt;
+	}
+	if ((source != nullptr) && !sameUri(*source, it->second.responder)) {
+		return std::nullopt;
+	}
+	auto handler = std::move(it->second.handler);
+	shard.handlers.erase(it);
+	return handler;
+}
+
+size_t ResponseTable::size() const {
+	size_t size = 0;
+	for (const auto& shard : shards_) {
+		std::lock_guard<std::mutex> lock(shard.mutex);
+		size += shard.handlers.size();
+	}
+	return size;
+}
+
+void ResponseTable::expire() {
+	std::unique_lock<std::mutex> lock(deadlines_mutex_);
+	while (!stop_) {
+		if (deadlines_.empty()) {
+			deadlines_cv_.wait(lock);
+			continue;
+		}
+		const auto next = deadlines_.top();
+		if (Clock::now() < next.when) {
+			deadlines_cv_.wait_until(lock, next.when);
+			continue;
+		}
+		deadlines_.pop();
+		lock.unlock();
+
+		// Handlers that already got their response are no longer in the table
+		auto handler = take(next.key, nullptr);
+		if (handler.has_value()) {
+			v1::UStatus status;
+			status.set_code(v1::UCode::DEADLINE_EXCEEDED);
+			status.set_message("No response received before the request TTL");
+			try {
+				(*handler)(utils::Unexpected<v1::UStatus>(std::move(status)));
+			} catch (const std::exception& e) {
+				spdlog::error("ResponseTable: response handler threw: {}",
+				              e.what());
+			}
+		}
+
+		lock.lock();
+	}
+}
+
+}  // namespace uprotocol::transport
@@ -0,0 +1,114 @@
+// SPDX-FileCopyrightText: 2024 Contributors to the Eclipse Foundation
+//
+// See the NOTICE file(s) distributed with this work for additional
+// information regarding copyright ownership.
+//
+// This program and the accompanying materials are made available under the
+// terms of the Apache License Version 2.0 which is available at
+// https://www.apache.org/licenses/LICENSE-2.0
+//
+// SPDX-License-Identifier: Apache-2.0
+
+#include "up-transport-zenoh-cpp/SendConflator.h"
+
+#include <spdlog/spdlog.h>
+
+#include <utility>
+#include <vector>
+
+namespace uprotocol::transport {
+
+SendConflator::SendConflator(
+    const std::map<std::string, std::chrono::milliseconds>& intervals,
+    Flush&& flush)
+    : flush_(std::move(flush)) {
+	for (const auto& [zenoh_key, interval] : intervals) {
+		slots_.emplace(zenoh_key, Slot{interval, {}, std::nullopt});
+	}
+	flusher_ = std::thread([this]() { run(); });
+}
+
+SendConflator::~SendConflator() {
+	{
+		std::lock_guard<std::mutex> lock(mutex_);
+		stop_ = true;
+	}
+	cv_.notify_all();
+	flusher_.join();
+}
+
+SendConflator::Action SendConflator::offer(const std::string& zenoh_key,
+                                           const v1::UMessage& message) {
+	std::lock_guard<std::mutex> lock(mutex_);
+	auto it = slots_.find(zenoh_key);
+	if (it == slots_.end()) {
+		return Action::SEND_NOW;
+	}
+
+	auto& slot = it->second;
+	const auto now = Clock::now();
+	if (!slot.pending.has_value() && (now >= slot.last_sent + slot.interval)) {
+		slot.last_sent = now;
+		return Action::SEND_NOW;
+	}
+
+	if (slot.pending.has_value()) {
+		conflated_.increment(zenoh_key);
+	} else {
+		cv_.notify_one();
+	}
+	slot.pending = message;
+	return Action::DEFERRED;
+}
+
+void SendConflator::run() {
+	std::vector<std::pair<std::string, v1::UMessage>> due;
+
+	std::unique_lock<std::mutex> lock(mutex_);
+	while (true) {
+		// Once stopping, every held message is flushed regardless of its
+		// interval: send() already reported it as accepted.
+		const bool stopping = stop_;
+		const auto now = Clock::now();
+		std::optional<Clock::time_point> next_due;
+		for (auto& [zenoh_key, slot] : slots_) {
+			if (!slot.pending.has_value()) {
+				continue;
+			}
+			const auto slot_due = slot.last_sent + slot.interval;
+			if (stopping || (slot_due <= now)) {
+				due.emplace_back(zenoh_key, std::move(*slot.pending));
+				slot.pending.reset();
+				slot.last_sent = now;
+			} else if (!next_due.has_value() || (slot_due < *next_due)) {
+				next_due = slot_due;
+			}
+		}
+
+		if (!due.empty()) {
+			lock.unlock();
+			for (const auto& [zenoh_key, message] : due) {
+				try {
+					flush_(zenoh_key, message);
+				} catch (const std::exception& e) {
+					spdlog::error("SendConflator: flush of {} failed: {}",
+					              zenoh_key, e.what());
+				}
+			}
+			due.clear();
+			lock.lock();
+			continue;
+		}
+
+		if (stopping) {
+			return;
+		}
+		if (next_due.has_value()) {
+			cv_.wait_until(lock, *next_due);
+		} else {
+			cv_.wait(lock);
+		}
+	}
+}
+
+}  // namespace uprotocol::transport
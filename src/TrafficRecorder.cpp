@@ -0,0 +1,205 @@
+// SPDX-FileCopyrightText: 2024 Contributors to the Eclipse Foundation
+//
+// See the NOTICE file(s) distributed with this work for additional
+// information regarding copyright ownership.
+//
+// This program and the accompanying materials are made available under the
+// terms of the Apache License Version 2.0 which is available at
+// https://www.apache.org/licenses/LICENSE-2.0
+//
+// SPDX-License-Identifier: Apache-2.0
+
+#include "up-transport-zenoh-cpp/TrafficRecorder.h"
+
+#include <fcntl.h>
+#include <spdlog/spdlog.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+#include <system_error>
+
+#include "up-transport-zenoh-cpp/UAttributesCodec.h"
+
+namespace uprotocol::transport {
+
+using capture_format::FileHeader;
+using capture_format::RecordHeader;
+using capture_format::RECORD_ALIGNMENT;
+
+namespace {
+
+size_t alignRecord(size_t size) {
+	return (size + RECORD_ALIGNMENT - 1) & ~(RECORD_ALIGNMENT - 1);
+}
+
+[[noreturn]] void throwErrno(const std::string& what) {
+	throw std::system_error(errno, std::generic_category(), what);
+}
+
+}  // namespace
+
+TrafficRecorder::TrafficRecorder(const std::filesystem::path& file,
+                                 size_t capacity)
+    : capacity_(std::max(capacity, sizeof(FileHeader))),
+      start_(std::chrono::steady_clock::now()),
+      end_(sizeof(FileHeader)) {
+	constexpr mode_t FILE_MODE = 0644;
+	fd_ = ::open(file.c_str(), O_RDWR | O_CREAT | O_TRUNC, FILE_MODE);
+	if (fd_ < 0) {
+		throwErrno("TrafficRecorder: cannot create " + file.string());
+	}
+	// The file is sparse, so only the pages written to take up space
+	if (::ftruncate(fd_, static_cast<off_t>(capacity_)) != 0) {
+		::close(fd_);
+		throwErrno("TrafficRecorder: cannot size " + file.string());
+	}
+	void* data =
+	    ::mmap(nullptr, capacity_, PROT_READ | PROT_WRITE, MAP_SHARED, fd_, 0);
+	if (data == MAP_FAILED) {
+		::close(fd_);
+		throwErrno("TrafficRecorder: cannot map " + file.string());
+	}
+	data_ = static_cast<uint8_t*>(data);
+
+	FileHeader header{};
+	header.magic = capture_format::MAGIC;
+	header.start_time_ns = static_cast<uint64_t>(
+	    std::chrono::duration_cast<std::chrono::nanoseconds>(
+	        std::chrono::system_clock::now().time_since_epoch())
+	        .count());
+	std::memcpy(data_, &header, sizeof(header));
+}
+
+TrafficRecorder::~TrafficRecorder() {
+	const size_t size = std::min(end_.load(), capacity_);
+	::msync(data_, size, MS_SYNC);
+	::munmap(data_, capacity_);
+	if (::ftruncate(fd_, static_cast<off_t>(size)) != 0) {
+		spdlog::warn("TrafficRecorder: cannot truncate capture: {}",
+		             std::strerror(errno));
+	}
+	::close(fd_);
+}
+
+void TrafficRecorder::record(Direction direction,
+                             const v1::UMessage& message) {
+	const auto& attributes = message.attributes();
+	const auto& payload = message.payload();
+	const size_t attributes_size = UAttributesCodec::encodedSize(attributes);
+	const size_t record_size =
+	    alignRecord(sizeof(RecordHeader) + attributes_size + payload.size());
+
+	const size_t offset = end_.fetch_add(record_size);
+	if ((offset + record_size) > capacity_) {
+		++dropped_;
+		return;
+	}
+
+	RecordHeader header{};
+	header.offset_ns = static_cast<uint64_t>(
+	    std::chrono::duration_cast<std::chrono::nanoseconds>(
+	        std::chrono::steady_clock::now() - start_)
+	        .count());
+	header.attributes_size = static_cast<uint32_t>(attributes_size);
+	header.payload_size = static_cast<uint32_t>(payload.size());
+	header.direction = direction;
+
+	uint8_t* out = data_ + offset;
+	std::memcpy(out, &header, sizeof(header));
+	out = UAttributesCodec::encode(attributes, out + sizeof(header));
+	std::memcpy(out, payload.data(), payload.size());
+	++recorded_;
+}
+
+TrafficCapture::TrafficCapture(const std::filesystem::path& file) {
+	fd_ = ::open(file.c_str(), O_RDONLY);
+	if (fd_ < 0) {
+		throwErrno("TrafficCapture: cannot open " + file.string());
+	}
+	struct stat file_stat {};
+	if (::fstat(fd_, &file_stat) != 0) {
+		::close(fd_);
+		throwErrno("TrafficCapture: cannot stat " + file.string());
+	}
+	size_ = static_cast<size_t>(file_stat.st_size);
+	if (size_ < sizeof(FileHeader)) {
+		::close(fd_);
+		throw std::runtime_error("TrafficCapture: not a capture file");
+	}
+
+	void* data = ::mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd_, 0);
+	if (data == MAP_FAILED) {
+		::close(fd_);
+		throwErrno("TrafficCapture: cannot map " + file.string());
+	}
+	data_ = static_cast<const uint8_t*>(data);
+
+	FileHeader header{};
+	std::memcpy(&header, data_, sizeof(header));
+	if (header.magic != capture_format::MAGIC) {
+		::munmap(const_cast<uint8_t*>(data_), size_);  // NOLINT
+		::close(fd_);
+		throw std::runtime_error("TrafficCapture: not a capture file");
+	}
+	rewind();
+}
+
+TrafficCapture::~TrafficCapture() {
+	::munmap(const_cast<uint8_t*>(data_), size_);  // NOLINT
+	::close(fd_);
+}
+
+std::chrono::system_clock::time_point TrafficCapture::startTime() const {
+	FileHeader header{};
+	std::memcpy(&header, data_, sizeof(header));
+	return std::chrono::system_clock::time_point(
+	    std::chrono::duration_cast<std::chrono::system_clock::duration>(
+	        std::chrono::nanoseconds(header.start_time_ns)));
+}
+
+bool TrafficCapture::next(Record& record) {
+	if ((size_ - position_) < sizeof(RecordHeader)) {
+		return false;
+	}
+	RecordHeader header{};
+	std::memcpy(&header, data_ + position_, sizeof(header));
+	if ((header.direction != capture_format::Direction::SENT) &&
+	    (header.direction != capture_format::Direction::RECEIVED)) {
+		return false;
+	}
+
+	const size_t record_size =
+	    alignRecord(sizeof(RecordHeader) + header.attributes_size +
+	                header.payload_size);
+	if ((size_ - position_) <
+	    (sizeof(RecordHeader) + header.attributes_size + header.payload_size)) {
+		spdlog::warn("TrafficCapture: truncated record at offset {}",
+		             position_);
+		return false;
+	}
+
+	const uint8_t* attributes = data_ + position_ + sizeof(RecordHeader);
+	if (!UAttributesCodec::decode(attributes, header.attributes_size,
+	                              *record.message.mutable_attributes())) {
+		spdlog::warn("TrafficCapture: malformed attributes at offset {}",
+		             position_);
+		return false;
+	}
+	record.message.mutable_payload()->assign(
+	    reinterpret_cast<const char*>(attributes + header.attributes_size),
+	    header.payload_size);
+	record.direction = header.direction;
+	record.offset = std::chrono::nanoseconds(header.offset_ns);
+
+	position_ = std::min(position_ + record_size, size_);
+	return true;
+}
+
+void TrafficCapture::rewind() { position_ = sizeof(FileHeader); }
+
+}  // namespace uprotocol::transport
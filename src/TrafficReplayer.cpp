@@ -0,0 +1,72 @@
+// SPDX-FileCopyrightText: 2024 Contributors to the Eclipse Foundation
+//
+// See the NOTICE file(s) distributed with this work for additional
+// information regarding copyright ownership.
+//
+// This program and the accompanying materials are made available under the
+// terms of the Apache License Version 2.0 which is available at
+// https://www.apache.org/licenses/LICENSE-2.0
+//
+// SPDX-License-Identifier: Apache-2.0
+
+#include "up-transport-zenoh-cpp/TrafficReplayer.h"
+
+#include <spdlog/spdlog.h>
+#include <up-cpp/datamodel/builder/Uuid.h>
+
+#include <chrono>
+#include <optional>
+#include <thread>
+
+#include "up-transport-zenoh-cpp/TrafficRecorder.h"
+
+namespace uprotocol::transport {
+
+TrafficReplayer::Stats TrafficReplayer::replay(
+    UTransport& transport, const std::filesystem::path& file,
+    const Options& options) {
+	TrafficCapture capture(file);
+	Stats stats;
+
+	// Records are scheduled relative to the first replayed record, so that
+	// any idle time before it is skipped.
+	std::optional<std::chrono::nanoseconds> first_offset;
+	const auto start = std::chrono::steady_clock::now();
+
+	TrafficCapture::Record record;
+	while (capture.next(record)) {
+		if (!options.replay_received &&
+		    (record.direction != capture_format::Direction::SENT)) {
+			continue;
+		}
+
+		if (!first_offset.has_value()) {
+			first_offset = record.offset;
+		}
+		if (options.speed > 0) {
+			const auto recorded_delay =
+			    static_cast<double>((record.offset - *first_offset).count());
+			const auto delay = std::chrono::duration_cast<
+			    std::chrono::steady_clock::duration>(
+			    std::chrono::duration<double, std::nano>(recorded_delay /
+			                                             options.speed));
+			std::this_thread::sleep_until(start + delay);
+		}
+
+		if (options.new_ids) {
+			*record.message.mutable_attributes()->mutable_id() =
+			    datamodel::builder::UuidBuilder::getBuilder().build();
+		}
+
+		auto status = transport.send(record.message);
+		if (status.code() == v1::UCode::OK) {
+			++stats.sent;
+		} else {
+			++stats.failed;
+			spdlog::debug("TrafficReplayer: send failed: {}", status.message());
+		}
+	}
+	return stats;
+}
+
+}  // namespace uprotocol::transport
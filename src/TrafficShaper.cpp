@@ -0,0 +1,133 @@
+// SPDX-FileCopyrightText: 2024 Contributors to the Eclipse Foundation
+//
+// See the NOTICE file(s) distributed with this work for additional
+// information regarding copyright ownership.
+//
+// This program and the accompanying materials are made available under the
+// terms of the Apache License Version 2.0 which is available at
+// https://www.apache.org/licenses/LICENSE-2.0
+//
+// SPDX-License-Identifier: Apache-2.0
+
+#include "up-transport-zenoh-cpp/TrafficShaper.h"
+
+#include <algorithm>
+#include <thread>
+
+#include "up-transport-zenoh-cpp/UAttributesCodec.h"
+
+namespace uprotocol::transport {
+
+TrafficShaper::Bucket::Bucket(const Rule& rule)
+    : rule(rule),
+      tokens(static_cast<double>(rule.burst_bytes)),
+      last_refill(Clock::now()) {}
+
+TrafficShaper::TrafficShaper(const std::vector<Rule>& rules)
+    : created_(Clock::now()) {
+	for (const auto& rule : rules) {
+		buckets_.push_back(std::make_unique<Bucket>(rule));
+	}
+}
+
+TrafficShaper::Bucket* TrafficShaper::select_(
+    std::string_view zenoh_key, const v1::UAttributes& attributes) const {
+	for (const auto& bucket : buckets_) {
+		const auto& rule = bucket->rule;
+		if (rule.priority.has_value() &&
+		    (*rule.priority != attributes.priority())) {
+			continue;
+		}
+		if (rule.source_entity.has_value() &&
+		    (*rule.source_entity != attributes.source().ue_id())) {
+			continue;
+		}
+		if (zenoh_key.substr(0, rule.key_prefix.size()) != rule.key_prefix) {
+			continue;
+		}
+		return bucket.get();
+	}
+	return nullptr;
+}
+
+void TrafficShaper::refill(Bucket& bucket, Clock::time_point now) {
+	const std::chrono::duration<double> elapsed = now - bucket.last_refill;
+	const double refilled = elapsed.count() * bucket.rule.bytes_per_second;
+	bucket.tokens = std::min(bucket.tokens + refilled,
+	                         static_cast<double>(bucket.rule.burst_bytes));
+	bucket.last_refill = now;
+}
+
+TrafficShaper::Decision TrafficShaper::admit(std::string_view zenoh_key,
+                                             const v1::UMessage& message) {
+	auto* bucket = select_(zenoh_key, message.attributes());
+	if (bucket == nullptr) {
+		return Decision::SEND;
+	}
+	const auto& rule = bucket->rule;
+
+	const size_t size =
+	    UAttributesCodec::encodedSize(message.attributes()) +
+	    message.payload().size();
+	const double cost = static_cast<double>(size);
+	// Messages larger than the burst size would never fit, so they only
+	// need a full bucket. They are still charged in full, and the debt
+	// holds back the messages after them.
+	const double needed =
+	    std::min(cost, static_cast<double>(rule.burst_bytes));
+
+	std::chrono::nanoseconds delay{0};
+	{
+		std::lock_guard<std::mutex> lock(bucket->mutex);
+		refill(*bucket, Clock::now());
+
+		if (bucket->tokens < needed) {
+			if (rule.over_limit == OverLimit::DROP) {
+				++bucket->stats.dropped;
+				return Decision::DROP;
+			}
+			// Delayed messages borrow from the bucket, so that each
+			// waits for the ones ahead of it.
+			const std::chrono::duration<double> wait(
+			    (needed - bucket->tokens) / rule.bytes_per_second);
+			if ((rule.over_limit == OverLimit::REJECT) ||
+			    (rule.bytes_per_second <= 0) || (wait > rule.max_delay)) {
+				++bucket->stats.rejected;
+				return Decision::REJECT;
+			}
+			delay = std::chrono::duration_cast<std::chrono::nanoseconds>(wait);
+			++bucket->stats.delayed;
+			bucket->stats.total_delay += delay;
+		}
+
+		bucket->tokens -= cost;
+		++bucket->stats.sent_messages;
+		bucket->stats.sent_bytes += size;
+	}
+
+	if (delay.count() > 0) {
+		std::this_thread::sleep_for(delay);
+	}
+	return Decision::SEND;
+}
+
+std::vector<TrafficShaper::RuleStats> TrafficShaper::stats() const {
+	const auto now = Clock::now();
+	const std::chrono::duration<double> age = now - created_;
+
+	std::vector<RuleStats> all_stats;
+	for (const auto& bucket : buckets_) {
+		std::lock_guard<std::mutex> lock(bucket->mutex);
+		refill(*bucket, now);
+		auto stats = bucket->stats;
+		stats.available_bytes = bucket->tokens;
+		if (age.count() > 0) {
+			stats.average_bytes_per_second =
+			    static_cast<double>(stats.sent_bytes) / age.count();
+		}
+		all_stats.push_back(stats);
+	}
+	return all_stats;
+}
+
+}  // namespace uprotocol::transport
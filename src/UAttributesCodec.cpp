@@ -0,0 +1,710 @@
+// SPDX-FileCopyrightText: 2024 Contributors to the Eclipse Foundation
+//
+// See the NOTICE file(s) distributed with this work for additional
+// information regarding copyright ownership.
+//
+// This program and the accompanying materials are made available under the
+// terms of the Apache License Version 2.0 which is available at
+// https://www.apache.org/licenses/LICENSE-2.0
+//
+// SPDX-License-Identifier: Apache-2.0
+
+#include "up-transport-zenoh-cpp/UAttributesCodec.h"
+
+#include <algorithm>
+#include <limits>
+#include <string>
+
+namespace uprotocol::transport {
+
+namespace {
+
+enum WireType : uint8_t {
+	WIRE_VARINT = 0,
+	WIRE_FIXED64 = 1,
+	WIRE_LENGTH_DELIMITED = 2,
+	WIRE_START_GROUP = 3,
+	WIRE_END_GROUP = 4,
+	WIRE_FIXED32 = 5
+};
+
+// Field numbers, from uattributes.proto, uuid.proto and uri.proto
+namespace uuid_field {
+constexpr uint32_t MSB = 1;
+constexpr uint32_t LSB = 2;
+}  // namespace uuid_field
+
+namespace uuri_field {
+constexpr uint32_t AUTHORITY_NAME = 1;
+constexpr uint32_t UE_ID = 2;
+constexpr uint32_t UE_VERSION_MAJOR = 3;
+constexpr uint32_t RESOURCE_ID = 4;
+}  // namespace uuri_field
+
+namespace attributes_field {
+constexpr uint32_t ID = 1;
+constexpr uint32_t TYPE = 2;
+constexpr uint32_t SOURCE = 3;
+constexpr uint32_t SINK = 4;
+constexpr uint32_t PRIORITY = 5;
+constexpr uint32_t TTL = 6;
+constexpr uint32_t PERMISSION_LEVEL = 7;
+constexpr uint32_t COMMSTATUS = 8;
+constexpr uint32_t REQID = 9;
+constexpr uint32_t TOKEN = 10;
+constexpr uint32_t TRACEPARENT = 11;
+constexpr uint32_t PAYLOAD_FORMAT = 12;
+}  // namespace attributes_field
+
+constexpr int TAG_TYPE_BITS = 3;
+constexpr uint8_t VARINT_PAYLOAD_MASK = 0x7F;
+constexpr uint8_t VARINT_CONTINUE = 0x80;
+constexpr int VARINT_PAYLOAD_BITS = 7;
+constexpr int MAX_VARINT_BYTES = 10;
+constexpr int MAX_TAG_BYTES = 5;
+constexpr size_t FIXED64_BYTES = 8;
+constexpr size_t FIXED32_BYTES = 4;
+constexpr int BITS_PER_BYTE = 8;
+// Matches the default recursion limit of the protobuf parser
+constexpr int MAX_DEPTH = 100;
+
+// Every field of the three messages has a single byte tag
+constexpr size_t TAG_BYTES = 1;
+
+// -------------------------------------------------------------- Encoding
+
+size_t varintSize(uint64_t value) {
+	size_t size = 1;
+	while (value >= VARINT_CONTINUE) {
+		value >>= VARINT_PAYLOAD_BITS;
+		++size;
+	}
+	return size;
+}
+
+// Enums are encoded as int32, so negative values take ten bytes
+uint64_t enumValue(int value) {
+	return static_cast<uint64_t>(static_cast<int64_t>(value));
+}
+
+size_t lengthDelimitedSize(size_t length) {
+	return TAG_BYTES + varintSize(length) + length;
+}
+
+uint8_t* writeVarint(uint64_t value, uint8_t* out) {
+	while (value >= VARINT_CONTINUE) {
+		*out++ = static_cast<uint8_t>(value | VARINT_CONTINUE);
+		value >>= VARINT_PAYLOAD_BITS;
+	}
+	*out++ = static_cast<uint8_t>(value);
+	return out;
+}
+
+uint8_t* writeTag(uint32_t field, WireType wire_type, uint8_t* out) {
+	return writeVarint((field << TAG_TYPE_BITS) | wire_type, out);
+}
+
+uint8_t* writeFixed64(uint32_t field, uint64_t value, uint8_t* out) {
+	out = writeTag(field, WIRE_FIXED64, out);
+	for (size_t byte = 0; byte < FIXED64_BYTES; ++byte) {
+		*out++ = static_cast<uint8_t>(value >> (byte * BITS_PER_BYTE));
+	}
+	return out;
+}
+
+uint8_t* writeVarintField(uint32_t field, uint64_t value, uint8_t* out) {
+	return writeVarint(value, writeTag(field, WIRE_VARINT, out));
+}
+
+uint8_t* writeString(uint32_t field, const std::string& value, uint8_t* out) {
+	out = writeVarint(value.size(),
+	                  writeTag(field, WIRE_LENGTH_DELIMITED, out));
+	return std::copy(value.begin(), value.end(), out);
+}
+
+size_t uuidSize(const v1::UUID& uuid) {
+	return ((uuid.msb() != 0) ? TAG_BYTES + FIXED64_BYTES : 0) +
+	       ((uuid.lsb() != 0) ? TAG_BYTES + FIXED64_BYTES : 0);
+}
+
+uint8_t* writeUuid(uint32_t field, const v1::UUID& uuid, uint8_t* out) {
+	out = writeVarint(uuidSize(uuid),
+	                  writeTag(field, WIRE_LENGTH_DELIMITED, out));
+	if (uuid.msb() != 0) {
+		out = writeFixed64(uuid_field::MSB, uuid.msb(), out);
+	}
+	if (uuid.lsb() != 0) {
+		out = writeFixed64(uuid_field::LSB, uuid.lsb(), out);
+	}
+	return out;
+}
+
+size_t uuriSize(const v1::UUri& uuri) {
+	size_t size = 0;
+	if (!uuri.authority_name().empty()) {
+		size += lengthDelimitedSize(uuri.authority_name().size());
+	}
+	if (uuri.ue_id() != 0) {
+		size += TAG_BYTES + varintSize(uuri.ue_id());
+	}
+	if (uuri.ue_version_major() != 0) {
+		size += TAG_BYTES + varintSize(uuri.ue_version_major());
+	}
+	if (uuri.resource_id() != 0) {
+		size += TAG_BYTES + varintSize(uuri.resource_id());
+	}
+	return size;
+}
+
+uint8_t* writeUuri(uint32_t field, const v1::UUri& uuri, uint8_t* out) {
+	out = writeVarint(uuriSize(uuri),
+	                  writeTag(field, WIRE_LENGTH_DELIMITED, out));
+	if (!uuri.authority_name().empty()) {
+		out = writeString(uuri_field::AUTHORITY_NAME, uuri.authority_name(),
+		                  out);
+	}
+	if (uuri.ue_id() != 0) {
+		out = writeVarintField(uuri_field::UE_ID, uuri.ue_id(), out);
+	}
+	if (uuri.ue_version_major() != 0) {
+		out = writeVarintField(uuri_field::UE_VERSION_MAJOR,
+		                       uuri.ue_version_major(), out);
+	}
+	if (uuri.resource_id() != 0) {
+		out = writeVarintField(uuri_field::RESOURCE_ID, uuri.resource_id(),
+		                       out);
+	}
+	return out;
+}
+
+// -------------------------------------------------------------- Decoding
+
+struct Reader {
+	const uint8_t* pos;
+	const uint8_t* end;
+
+	[[nodiscard]] size_t remaining() const {
+		return static_cast<size_t>(end - pos);
+	}
+
+	bool readVarint(uint64_t& value) {
+		value = 0;
+		for (int byte = 0; byte < MAX_VARINT_BYTES; ++byte) {
+			if (pos == end) {
+				return false;
+			}
+			const uint8_t next = *pos++;
+			value |= static_cast<uint64_t>(next & VARINT_PAYLOAD_MASK)
+			         << (byte * VARINT_PAYLOAD_BITS);
+			if ((next & VARINT_CONTINUE) == 0) {
+				return true;
+			}
+		}
+		return false;
+	}
+
+	// Like protobuf, tags are at most five bytes long and only their low
+	// 32 bits are kept.
+	bool readTag(uint32_t& field, WireType& wire_type) {
+		uint32_t tag = 0;
+		for (int byte = 0; byte < MAX_TAG_BYTES; ++byte) {
+			if (pos == end) {
+				return false;
+			}
+			const uint8_t next = *pos++;
+			tag |= static_cast<uint32_t>(next & VARINT_PAYLOAD_MASK)
+			       << (byte * VARINT_PAYLOAD_BITS);
+			if ((next & VARINT_CONTINUE) == 0) {
+				field = tag >> TAG_TYPE_BITS;
+				wire_type =
+				    static_cast<WireType>(tag & ((1U << TAG_TYPE_BITS) - 1));
+				return true;
+			}
+		}
+		return false;
+	}
+
+	bool readFixed64(uint64_t& value) {
+		if (remaining() < FIXED64_BYTES) {
+			return false;
+		}
+		value = 0;
+		for (size_t byte = 0; byte < FIXED64_BYTES; ++byte) {
+			value |= static_cast<uint64_t>(*pos++) << (byte * BITS_PER_BYTE);
+		}
+		return true;
+	}
+
+	// Reads the length of a length-delimited field and returns a reader
+	// limited to its contents.
+	bool readLengthDelimited(Reader& contents) {
+		uint64_t length = 0;
+		if (!readVarint(length) ||
+		    (length > static_cast<uint64_t>(std::numeric_limits<int>::max())) ||
+		    (length > remaining())) {
+			return false;
+		}
+		contents = {pos, pos + length};
+		pos += length;
+		return true;
+	}
+};
+
+// Checks for well-formed UTF-8, as protobuf requires of proto3 strings:
+// no overlong encodings, surrogates or code points past U+10FFFF.
+bool isValidUtf8(const uint8_t* pos, const uint8_t* end) {
+	constexpr uint8_t ASCII_END = 0x80;
+	constexpr uint8_t CONTINUATION_MASK = 0xC0;
+	constexpr uint8_t CONTINUATION = 0x80;
+	constexpr uint8_t TWO_BYTE_START = 0xC2;
+	constexpr uint8_t THREE_BYTE_START = 0xE0;
+	constexpr uint8_t FOUR_BYTE_START = 0xF0;
+	constexpr uint8_t FOUR_BYTE_END = 0xF4;
+	constexpr uint8_t SURROGATE_LEAD = 0xED;
+	constexpr uint8_t LOWEST_CONTINUATION = 0x80;
+	constexpr uint8_t HIGHEST_CONTINUATION = 0xBF;
+	constexpr uint8_t THREE_BYTE_NON_OVERLONG = 0xA0;
+	constexpr uint8_t BELOW_SURROGATES = 0x9F;
+	constexpr uint8_t FOUR_BYTE_NON_OVERLONG = 0x90;
+	constexpr uint8_t BELOW_U10FFFF = 0x8F;
+
+	while (pos < end) {
+		const uint8_t lead = *pos++;
+		if (lead < ASCII_END) {
+			continue;
+		}
+
+		size_t continuations = 0;
+		uint8_t second_low = LOWEST_CONTINUATION;
+		uint8_t second_high = HIGHEST_CONTINUATION;
+		if ((lead >= TWO_BYTE_START) && (lead < THREE_BYTE_START)) {
+			continuations = 1;
+		} else if ((lead >= THREE_BYTE_START) && (lead < FOUR_BYTE_START)) {
+			continuations = 2;
+			if (lead == THREE_BYTE_START) {
+				second_low = THREE_BYTE_NON_OVERLONG;
+			} else if (lead == SURROGATE_LEAD) {
+				second_high = BELOW_SURROGATES;
+			}
+		} else if ((lead >= FOUR_BYTE_START) && (lead <= FOUR_BYTE_END)) {
+			continuations = 3;
+			if (lead == FOUR_BYTE_START) {
+				second_low = FOUR_BYTE_NON_OVERLONG;
+			} else if (lead == FOUR_BYTE_END) {
+				second_high = BELOW_U10FFFF;
+			}
+		} else {
+			return false;
+		}
+
+		if (static_cast<size_t>(end - pos) < continuations) {
+			return false;
+		}
+		if ((*pos < second_low) || (*pos > second_high)) {
+			return false;
+		}
+		for (size_t i = 0; i < continuations; ++i) {
+			if ((*pos++ & CONTINUATION_MASK) != CONTINUATION) {
+				return false;
+			}
+		}
+	}
+	return true;
+}
+
+bool readString(Reader& reader, std::string& value) {
+	Reader contents{};
+	if (!reader.readLengthDelimited(contents) ||
+	    !isValidUtf8(contents.pos, contents.end)) {
+		return false;
+	}
+	value.assign(reinterpret_cast<const char*>(contents.pos),
+	             contents.remaining());
+	return true;
+}
+
+bool skipField(Reader& reader, uint32_t field, WireType wire_type, int depth);
+
+// Skips the contents of a group up to its matching end tag
+bool skipGroup(Reader& reader, uint32_t group_field, int depth) {
+	if (depth > MAX_DEPTH) {
+		return false;
+	}
+	while (reader.pos < reader.end) {
+		uint32_t field = 0;
+		WireType wire_type = WIRE_VARINT;
+		if (!reader.readTag(field, wire_type) || (field == 0)) {
+			return false;
+		}
+		if (wire_type == WIRE_END_GROUP) {
+			return field == group_field;
+		}
+		if (!skipField(reader, field, wire_type, depth)) {
+			return false;
+		}
+	}
+	return false;
+}
+
+// Skips an unknown field, or a known field with an unexpected wire type,
+// the same way protobuf keeps it as an unknown field.
+bool skipField(Reader& reader, uint32_t field, WireType wire_type,
+               int depth) {
+	switch (wire_type) {
+		case WIRE_VARINT: {
+			uint64_t value = 0;
+			return reader.readVarint(value);
+		}
+		case WIRE_FIXED64: {
+			uint64_t value = 0;
+			return reader.readFixed64(value);
+		}
+		case WIRE_LENGTH_DELIMITED: {
+			Reader contents{};
+			return reader.readLengthDelimited(contents);
+		}
+		case WIRE_START_GROUP:
+			return skipGroup(reader, field, depth + 1);
+		case WIRE_FIXED32:
+			if (reader.remaining() < FIXED32_BYTES) {
+				return false;
+			}
+			reader.pos += FIXED32_BYTES;
+			return true;
+		case WIRE_END_GROUP:
+		default:
+			return false;
+	}
+}
+
+// Calls on_field(reader, field) for each field whose wire type is expected
+// for its field number, and skips all others.
+template <typename ExpectedWireType, typename OnField>
+bool readFields(Reader& reader, int depth, ExpectedWireType expected,
+                OnField on_field) {
+	while (reader.pos < reader.end) {
+		uint32_t field = 0;
+		WireType wire_type = WIRE_VARINT;
+		if (!reader.readTag(field, wire_type) || (field == 0)) {
+			return false;
+		}
+		const bool ok = (expected(field) == wire_type)
+		                    ? on_field(reader, field)
+		                    : skipField(reader, field, wire_type, depth);
+		if (!ok) {
+			return false;
+		}
+	}
+	return true;
+}
+
+// The wire type of fields that aren't part of a message is never matched
+constexpr auto UNKNOWN_FIELD = static_cast<WireType>(0xFF);
+
+bool readUuid(Reader& reader, v1::UUID& uuid, int depth) {
+	Reader contents{};
+	if (!reader.readLengthDelimited(contents) || (depth > MAX_DEPTH)) {
+		return false;
+	}
+	auto expected = [](uint32_t field) {
+		return ((field == uuid_field::MSB) || (field == uuid_field::LSB))
+		           ? WIRE_FIXED64
+		           : UNKNOWN_FIELD;
+	};
+	return readFields(
+	    contents, depth, expected, [&uuid](Reader& fields, uint32_t field) {
+		    uint64_t value = 0;
+		    if (!fields.readFixed64(value)) {
+			    return false;
+		    }
+		    if (field == uuid_field::MSB) {
+			    uuid.set_msb(value);
+		    } else {
+			    uuid.set_lsb(value);
+		    }
+		    return true;
+	    });
+}
+
+bool readUuri(Reader& reader, v1::UUri& uuri, int depth) {
+	Reader contents{};
+	if (!reader.readLengthDelimited(contents) || (depth > MAX_DEPTH)) {
+		return false;
+	}
+	auto expected = [](uint32_t field) {
+		switch (field) {
+			case uuri_field::AUTHORITY_NAME:
+				return WIRE_LENGTH_DELIMITED;
+			case uuri_field::UE_ID:
+			case uuri_field::UE_VERSION_MAJOR:
+			case uuri_field::RESOURCE_ID:
+				return WIRE_VARINT;
+			default:
+				return UNKNOWN_FIELD;
+		}
+	};
+	return readFields(
+	    contents, depth, expected, [&uuri](Reader& fields, uint32_t field) {
+		    if (field == uuri_field::AUTHORITY_NAME) {
+			    return readString(fields, *uuri.mutable_authority_name());
+		    }
+		    uint64_t value = 0;
+		    if (!fields.readVarint(value)) {
+			    return false;
+		    }
+		    // uint32 fields keep the low 32 bits of the varint
+		    const auto value32 = static_cast<uint32_t>(value);
+		    if (field == uuri_field::UE_ID) {
+			    uuri.set_ue_id(value32);
+		    } else if (field == uuri_field::UE_VERSION_MAJOR) {
+			    uuri.set_ue_version_major(value32);
+		    } else {
+			    uuri.set_resource_id(value32);
+		    }
+		    return true;
+	    });
+}
+
+WireType expectedAttributesWireType(uint32_t field) {
+	switch (field) {
+		case attributes_field::ID:
+		case attributes_field::SOURCE:
+		case attributes_field::SINK:
+		case attributes_field::REQID:
+		case attributes_field::TOKEN:
+		case attributes_field::TRACEPARENT:
+			return WIRE_LENGTH_DELIMITED;
+		case attributes_field::TYPE:
+		case attributes_field::PRIORITY:
+		case attributes_field::TTL:
+		case attributes_field::PERMISSION_LEVEL:
+		case attributes_field::COMMSTATUS:
+		case attributes_field::PAYLOAD_FORMAT:
+			return WIRE_VARINT;
+		default:
+			return UNKNOWN_FIELD;
+	}
+}
+
+bool readAttributesField(Reader& reader, uint32_t field,
+                         v1::UAttributes& attributes) {
+	constexpr int SUBMESSAGE_DEPTH = 1;
+	switch (field) {
+		case attributes_field::ID:
+			return readUuid(reader, *attributes.mutable_id(),
+			                SUBMESSAGE_DEPTH);
+		case attributes_field::SOURCE:
+			return readUuri(reader, *attributes.mutable_source(),
+			                SUBMESSAGE_DEPTH);
+		case attributes_field::SINK:
+			return readUuri(reader, *attributes.mutable_sink(),
+			                SUBMESSAGE_DEPTH);
+		case attributes_field::REQID:
+			return readUuid(reader, *attributes.mutable_reqid(),
+			                SUBMESSAGE_DEPTH);
+		case attributes_field::TOKEN:
+			return readString(reader, *attributes.mutable_token());
+		case attributes_field::TRACEPARENT:
+			return readString(reader, *attributes.mutable_traceparent());
+		default:
+			break;
+	}
+
+	uint64_t value = 0;
+	if (!reader.readVarint(value)) {
+		return false;
+	}
+	// uint32 and enum (int32) fields keep the low 32 bits of the varint
+	const auto value32 = static_cast<uint32_t>(value);
+	const auto enum_value = static_cast<int>(value32);
+	switch (field) {
+		case attributes_field::TYPE:
+			attributes.set_type(static_cast<v1::UMessageType>(enum_value));
+			break;
+		case attributes_field::PRIORITY:
+			attributes.set_priority(static_cast<v1::UPriority>(enum_value));
+			break;
+		case attributes_field::TTL:
+			attributes.set_ttl(value32);
+			break;
+		case attributes_field::PERMISSION_LEVEL:
+			attributes.set_permission_level(value32);
+			break;
+		case attributes_field::COMMSTATUS:
+			attributes.set_commstatus(static_cast<v1::UCode>(enum_value));
+			break;
+		case attributes_field::PAYLOAD_FORMAT:
+			attributes.set_payload_format(
+			    static_cast<v1::UPayloadFormat>(enum_value));
+			break;
+		default:
+			return false;
+	}
+	return true;
+}
+
+void clearKeepingAllocations(v1::UAttributes& attributes) {
+	if (attributes.has_id()) {
+		attributes.mutable_id()->Clear();
+	}
+	if (attributes.has_source()) {
+		attributes.mutable_source()->Clear();
+	}
+	if (attributes.has_sink()) {
+		attributes.mutable_sink()->Clear();
+	}
+	if (attributes.has_reqid()) {
+		attributes.mutable_reqid()->Clear();
+	}
+	attributes.clear_type();
+	attributes.clear_priority();
+	attributes.clear_ttl();
+	attributes.clear_permission_level();
+	attributes.clear_commstatus();
+	attributes.clear_token();
+	attributes.clear_traceparent();
+	attributes.clear_payload_format();
+	const auto* reflection = attributes.GetReflection();
+	if (!reflection->GetUnknownFields(attributes).empty()) {
+		reflection->MutableUnknownFields(&attributes)->Clear();
+	}
+}
+
+}  // namespace
+
+size_t UAttributesCodec::encodedSizeBeforeSink(
+    const v1::UAttributes& attributes) {
+	size_t size = 0;
+	if (attributes.has_id()) {
+		size += lengthDelimitedSize(uuidSize(attributes.id()));
+	}
+	if (attributes.type() != 0) {
+		size += TAG_BYTES + varintSize(enumValue(attributes.type()));
+	}
+	if (attributes.has_source()) {
+		size += lengthDelimitedSize(uuriSize(attributes.source()));
+	}
+	return size;
+}
+
+size_t UAttributesCodec::encodedSinkSize(const v1::UUri& sink) {
+	return lengthDelimitedSize(uuriSize(sink));
+}
+
+uint8_t* UAttributesCodec::encodeSink(const v1::UUri& sink, uint8_t* buffer) {
+	return writeUuri(attributes_field::SINK, sink, buffer);
+}
+
+size_t UAttributesCodec::encodedSize(const v1::UAttributes& attributes) {
+	size_t size = encodedSizeBeforeSink(attributes);
+	if (attributes.has_sink()) {
+		size += encodedSinkSize(attributes.sink());
+	}
+	if (attributes.priority() != 0) {
+		size += TAG_BYTES + varintSize(enumValue(attributes.priority()));
+	}
+	if (attributes.has_ttl()) {
+		size += TAG_BYTES + varintSize(attributes.ttl());
+	}
+	if (attributes.has_permission_level()) {
+		size += TAG_BYTES + varintSize(attributes.permission_level());
+	}
+	if (attributes.has_commstatus()) {
+		size += TAG_BYTES + varintSize(enumValue(attributes.commstatus()));
+	}
+	if (attributes.has_reqid()) {
+		size += lengthDelimitedSize(uuidSize(attributes.reqid()));
+	}
+	if (attributes.has_token()) {
+		size += lengthDelimitedSize(attributes.token().size());
+	}
+	if (attributes.has_traceparent()) {
+		size += lengthDelimitedSize(attributes.traceparent().size());
+	}
+	if (attributes.payload_format() != 0) {
+		size += TAG_BYTES + varintSize(enumValue(attributes.payload_format()));
+	}
+	return size;
+}
+
+uint8_t* UAttributesCodec::encode(const v1::UAttributes& attributes,
+                                  uint8_t* buffer) {
+	using namespace attributes_field;  // NOLINT(google-build-using-namespace)
+
+	auto* out = buffer;
+	if (attributes.has_id()) {
+		out = writeUuid(ID, attributes.id(), out);
+	}
+	if (attributes.type() != 0) {
+		out = writeVarintField(TYPE, enumValue(attributes.type()), out);
+	}
+	if (attributes.has_source()) {
+		out = writeUuri(SOURCE, attributes.source(), out);
+	}
+	if (attributes.has_sink()) {
+		out = writeUuri(SINK, attributes.sink(), out);
+	}
+	if (attributes.priority() != 0) {
+		out = writeVarintField(PRIORITY, enumValue(attributes.priority()), out);
+	}
+	if (attributes.has_ttl()) {
+		out = writeVarintField(TTL, attributes.ttl(), out);
+	}
+	if (attributes.has_permission_level()) {
+		out = writeVarintField(PERMISSION_LEVEL, attributes.permission_level(),
+		                       out);
+	}
+	if (attributes.has_commstatus()) {
+		out = writeVarintField(COMMSTATUS, enumValue(attributes.commstatus()),
+		                       out);
+	}
+	if (attributes.has_reqid()) {
+		out = writeUuid(REQID, attributes.reqid(), out);
+	}
+	if (attributes.has_token()) {
+		out = writeString(TOKEN, attributes.token(), out);
+	}
+	if (attributes.has_traceparent()) {
+		out = writeString(TRACEPARENT, attributes.traceparent(), out);
+	}
+	if (attributes.payload_format() != 0) {
+		out = writeVarintField(PAYLOAD_FORMAT,
+		                       enumValue(attributes.payload_format()), out);
+	}
+	return out;
+}
+
+bool UAttributesCodec::decode(const uint8_t* data, size_t size,
+                              v1::UAttributes& attributes) {
+	// UAttributes::Clear() deletes submessages, so they are cleared in place
+	// instead and only removed if the input doesn't contain them.
+	clearKeepingAllocations(attributes);
+
+	uint32_t seen = 0;
+	Reader reader{data, data + size};
+	const bool ok = readFields(
+	    reader, 0, expectedAttributesWireType,
+	    [&attributes, &seen](Reader& fields, uint32_t field) {
+		    seen |= 1U << field;
+		    return readAttributesField(fields, field, attributes);
+	    });
+
+	auto was_seen = [seen](uint32_t field) {
+		return (seen & (1U << field)) != 0;
+	};
+	if (!was_seen(attributes_field::ID)) {
+		attributes.clear_id();
+	}
+	if (!was_seen(attributes_field::SOURCE)) {
+		attributes.clear_source();
+	}
+	if (!was_seen(attributes_field::SINK)) {
+		attributes.clear_sink();
+	}
+	if (!was_seen(attributes_field::REQID)) {
+		attributes.clear_reqid();
+	}
+	return ok;
+}
+
+}  // namespace uprotocol::transport
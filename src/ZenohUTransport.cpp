@@ -14,8 +14,17 @@
 #include <spdlog/spdlog.h>
 #include <up-cpp/datamodel/serializer/UUri.h>
 #include <up-cpp/datamodel/serializer/Uuid.h>
+#include <up-cpp/datamodel/validator/UMessage.h>
+#include <up-cpp/datamodel/validator/UUri.h>
 
+#include <algorithm>
+#include <atomic>
+#include <map>
+#include <sstream>
 #include <stdexcept>
+#include <thread>
+
+#include "up-transport-zenoh-cpp/UAttributesCodec.h"
 
 namespace uprotocol::transport {
 
@@ -25,6 +34,103 @@ constexpr uint32_t WILDCARD_ENTITY_ID = 0x0000FFFF;
 constexpr uint32_t WILDCARD_ENTITY_VERSION = 0x000000FF;
 constexpr uint32_t WILDCARD_RESOURCE_ID = 0x0000FFFF;
 
+namespace {
+
+bool isPublishOrNotification(v1::UMessageType type) {
+	return (type == v1::UMessageType::UMESSAGE_TYPE_PUBLISH) ||
+	       (type == v1::UMessageType::UMESSAGE_TYPE_NOTIFICATION);
+}
+
+// Writes the "/authority/ue_id/version/resource" part of a zenoh key
+void writeUUriKey(std::ostringstream& zenoh_key,
+                  const std::string& default_authority_name,
+                  const v1::UUri& uuri) {
+	zenoh_key << "/";
+
+	// authority_name
+	if (uuri.authority_name().empty()) {
+		zenoh_key << default_authority_name;
+	} else {
+		zenoh_key << uuri.authority_name();
+	}
+	zenoh_key << "/";
+
+	// ue_id
+	if (uuri.ue_id() == WILDCARD_ENTITY_ID) {
+		zenoh_key << "*";
+	} else {
+		zenoh_key << std::uppercase << std::hex << uuri.ue_id();
+	}
+	zenoh_key << "/";
+
+	// ue_version_major
+	if (uuri.ue_version_major() == WILDCARD_ENTITY_VERSION) {
+		zenoh_key << "*";
+	} else {
+		zenoh_key << std::uppercase << std::hex << uuri.ue_version_major();
+	}
+	zenoh_key << "/";
+
+	// resource_id
+	if (uuri.resource_id() == WILDCARD_RESOURCE_ID) {
+		zenoh_key << "*";
+	} else {
+		zenoh_key << std::uppercase << std::hex << uuri.resource_id();
+	}
+}
+
+// Zenoh timestamps are NTP64: seconds since the Unix epoch in the upper 32
+// bits, and fractions of a second in the lower 32 bits.
+std::chrono::system_clock::time_point fromNtp64(uint64_t ntp64) {
+	constexpr unsigned FRACTION_BITS = 32;
+	constexpr uint64_t FRACTION_MASK = 0xFFFFFFFF;
+	constexpr uint64_t NS_PER_SECOND = 1000000000;
+	const uint64_t seconds = ntp64 >> FRACTION_BITS;
+	const uint64_t nanoseconds =
+	    ((ntp64 & FRACTION_MASK) * NS_PER_SECOND) >> FRACTION_BITS;
+	return std::chrono::system_clock::time_point(
+	    std::chrono::duration_cast<std::chrono::system_clock::duration>(
+	        std::chrono::seconds(seconds) +
+	        std::chrono::nanoseconds(nanoseconds)));
+}
+
+// Bytes within a serialized attachment
+struct Span {
+	const uint8_t* data = nullptr;
+	size_t size = 0;
+};
+
+// Reads a LEB128 length, as written by zenoh::ext::serialize()
+bool readLength(const uint8_t*& data, const uint8_t* end, size_t& length) {
+	constexpr unsigned BITS_PER_BYTE = 7;
+	constexpr unsigned MAX_SHIFT = 63;
+	constexpr uint8_t VALUE_MASK = 0x7F;
+	constexpr uint8_t MORE = 0x80;
+	length = 0;
+	for (unsigned shift = 0; (data < end) && (shift <= MAX_SHIFT);
+	     shift += BITS_PER_BYTE) {
+		const uint8_t byte = *data++;
+		length |= static_cast<size_t>(byte & VALUE_MASK) << shift;
+		if ((byte & MORE) == 0) {
+			return true;
+		}
+	}
+	return false;
+}
+
+// Reads a length-prefixed string or byte vector
+bool readSpan(const uint8_t*& data, const uint8_t* end, Span& span) {
+	if (!readLength(data, end, span.size) ||
+	    (span.size > static_cast<size_t>(end - data))) {
+		return false;
+	}
+	span.data = data;
+	data += span.size;
+	return true;
+}
+
+}  // namespace
+
 v1::UStatus ZenohUTransport::uError(v1::UCode code, std::string_view message) {
 	v1::UStatus status;
 	status.set_code(code);
@@ -37,47 +143,12 @@ std::string ZenohUTransport::toZenohKeyString(
     const std::optional<v1::UUri>& sink) {
 	std::ostringstream zenoh_key;
 
-	auto write_u_uri = [&](const v1::UUri& uuri) {
-		zenoh_key << "/";
-
-		// authority_name
-		if (uuri.authority_name().empty()) {
-			zenoh_key << default_authority_name;
-		} else {
-			zenoh_key << uuri.authority_name();
-		}
-		zenoh_key << "/";
-
-		// ue_id
-		if (uuri.ue_id() == WILDCARD_ENTITY_ID) {
-			zenoh_key << "*";
-		} else {
-			zenoh_key << std::uppercase << std::hex << uuri.ue_id();
-		}
-		zenoh_key << "/";
-
-		// ue_version_major
-		if (uuri.ue_version_major() == WILDCARD_ENTITY_VERSION) {
-			zenoh_key << "*";
-		} else {
-			zenoh_key << std::uppercase << std::hex << uuri.ue_version_major();
-		}
-		zenoh_key << "/";
-
-		// resource_id
-		if (uuri.resource_id() == WILDCARD_RESOURCE_ID) {
-			zenoh_key << "*";
-		} else {
-			zenoh_key << std::uppercase << std::hex << uuri.resource_id();
-		}
-	};
-
 	zenoh_key << "up";
 
-	write_u_uri(source);
+	writeUUriKey(zenoh_key, default_authority_name, source);
 
 	if (sink.has_value()) {
-		write_u_uri(*sink);
+		writeUUriKey(zenoh_key, default_authority_name, *sink);
 	} else {
 		zenoh_key << "/{}/{}/{}/{}";
 	}
@@ -90,34 +161,53 @@ ZenohUTransport::uattributesToAttachment(const v1::UAttributes& attributes) {
 
 	std::vector<uint8_t> version = {UATTRIBUTE_VERSION};
 
-	std::vector<uint8_t> data(attributes.ByteSizeLong());
-	attributes.SerializeToArray(data.data(), static_cast<int>(data.size()));
+	std::vector<uint8_t> data(UAttributesCodec::encodedSize(attributes));
+	UAttributesCodec::encode(attributes, data.data());
 
 	res.emplace_back("", version);
 	res.emplace_back("", data);
 	return res;
 }
 
-v1::UAttributes ZenohUTransport::attachmentToUAttributes(
-    const zenoh::Bytes& attachment) {
-	auto attachment_vec = zenoh::ext::deserialize<
-	    std::vector<std::pair<std::string, std::vector<uint8_t>>>>(attachment);
+bool ZenohUTransport::attachmentToUAttributes(const zenoh::Bytes& attachment,
+                                              v1::UAttributes& attributes) {
+	// The attachment is the serialization of {("", {version}), ("", data)}:
+	// a count, then the length-prefixed key and value of each pair. It is
+	// read in place, so that nothing but the attributes is decoded.
+	std::vector<uint8_t> copy;
+	const uint8_t* data = nullptr;
+	const uint8_t* end = nullptr;
+	const auto slice = attachment.slice_iter().next();
+	if (slice.has_value() && (slice->len == attachment.size())) {
+		data = slice->data;
+		end = data + slice->len;
+	} else {
+		// Attachments split over several slices are copied first
+		copy = attachment.as_vector();
+		data = copy.data();
+		end = data + copy.size();
+	}
 
-	if (attachment_vec.size() != 2) {
-		spdlog::error("attachmentToUAttributes: attachment size != 2");
-		// TODO(unknown) error report, exception?
+	size_t count = 0;
+	Span key;
+	Span version;
+	Span encoded;
+	if (!readLength(data, end, count) || (count != 2) ||
+	    !readSpan(data, end, key) || !readSpan(data, end, version) ||
+	    !readSpan(data, end, key) || !readSpan(data, end, encoded)) {
+		spdlog::error("attachmentToUAttributes: malformed attachment");
+		return false;
 	}
 
-	if (attachment_vec[0].second.size() == 1) {
-		if (attachment_vec[0].second[0] != UATTRIBUTE_VERSION) {
-			spdlog::error("attachmentToUAttributes: incorrect version");
-			// TODO(unknown) error report, exception?
-		}
-	};
-	v1::UAttributes res;
-	const std::vector<uint8_t> data = attachment_vec[1].second;
-	res.ParseFromArray(data.data(), static_cast<int>(data.size()));
-	return res;
+	if ((version.size != 1) || (version.data[0] != UATTRIBUTE_VERSION)) {
+		spdlog::error("attachmentToUAttributes: incorrect version");
+		// TODO(unknown) error report, exception?
+	}
+	if (!UAttributesCodec::decode(encoded.data, encoded.size, attributes)) {
+		spdlog::error("attachmentToUAttributes: invalid uAttributes");
+		return false;
+	}
+	return true;
 }
 
 zenoh::Priority ZenohUTransport::mapZenohPriority(v1::UPriority upriority) {
@@ -154,18 +244,34 @@ zenoh::Priority ZenohUTransport::mapZenohPriority(v1::UPriority upriority) {
 	}
 }
 
-std::optional<v1::UMessage> ZenohUTransport::sampleToUMessage(
-    const zenoh::Sample& sample) {
-	v1::UMessage message;
+bool ZenohUTransport::isExpired(const v1::UAttributes& attributes,
+                                std::chrono::system_clock::time_point now) {
+	if (!attributes.has_ttl() || (attributes.ttl() == 0)) {
+		return false;
+	}
+
+	// The top 48 bits of a UUIDv7 are the Unix timestamp in milliseconds
+	constexpr int UUID_TIMESTAMP_SHIFT = 16;
+	const std::chrono::milliseconds created(
+	    attributes.id().msb() >> UUID_TIMESTAMP_SHIFT);
+	const std::chrono::milliseconds ttl(attributes.ttl());
+
+	return (now.time_since_epoch() - created) > ttl;
+}
+
+bool ZenohUTransport::sampleToUAttributes(const zenoh::Sample& sample,
+                                          v1::UAttributes& attributes) {
 	const auto attachment = sample.get_attachment();
-	if (attachment.has_value()) {
-		*message.mutable_attributes() =
-		    attachmentToUAttributes(attachment.value());
-	} else {
+	if (!attachment.has_value()) {
 		spdlog::error(
-		    "sampleToUMessage: empty attachment, cannot read uAttributes");
-		return std::nullopt;
+		    "sampleToUAttributes: empty attachment, cannot read uAttributes");
+		return false;
 	}
+	return attachmentToUAttributes(attachment.value(), attributes);
+}
+
+void ZenohUTransport::samplePayloadToUMessage(const zenoh::Sample& sample,
+                                              v1::UMessage& message) {
 	auto payload(
 	    zenoh::ext::deserialize<std::vector<uint8_t>>(sample.get_payload()));
 
@@ -173,22 +279,21 @@ std::optional<v1::UMessage> ZenohUTransport::sampleToUMessage(
 		std::string payload_as_string(payload.begin(), payload.end());
 		message.set_payload(std::move(payload_as_string));
 	}
-
-	return message;
 }
 
 std::optional<v1::UMessage> ZenohUTransport::queryToUMessage(
     const zenoh::Query& query) {
 	v1::UMessage message;
 	const auto attachment = query.get_attachment();
-	if (attachment.has_value()) {
-		*message.mutable_attributes() =
-		    attachmentToUAttributes(attachment.value());
-	} else {
+	if (!attachment.has_value()) {
 		spdlog::error(
 		    "queryToUMessage: empty attachment, cannot read uAttributes");
 		return std::nullopt;
 	}
+	if (!attachmentToUAttributes(attachment.value(),
+	                             *message.mutable_attributes())) {
+		return std::nullopt;
+	}
 	if (query.get_payload().has_value()) {
 		auto payload(zenoh::ext::deserialize<std::string>(
 		    query.get_payload().value().get()));
@@ -200,36 +305,786 @@ std::optional<v1::UMessage> ZenohUTransport::queryToUMessage(
 
 ZenohUTransport::ZenohUTransport(const v1::UUri& default_uri,
                                  const std::filesystem::path& config_file)
+    : ZenohUTransport(default_uri, config_file, ZenohUTransportOptions{}) {}
+
+ZenohUTransport::ZenohUTransport(const v1::UUri& default_uri,
+                                 const std::filesystem::path& config_file,
+                                 const ZenohUTransportOptions& options)
     : UTransport(default_uri),
-      session_(zenoh::Session::open(
-          zenoh::Config::from_file(config_file.string()))) {
-	// TODO(unknown) add to setup or remove
-	spdlog::set_level(spdlog::level::debug);
+      options_(options),
+      construction_start_(std::chrono::steady_clock::now()) {
+	// Configuration errors are always reported by the constructor
+	auto config = zenoh::Config::from_file(config_file.string());
+	std::vector<zenoh::Config> send_configs;
+	for (size_t session = 1; session < options_.send_sessions; ++session) {
+		auto send_config = zenoh::Config::from_file(config_file.string());
+		// Only one session can listen on the configured endpoints
+		send_config.insert_json5("listen/endpoints", "[]");
+		send_configs.push_back(std::move(send_config));
+	}
+	startup_timings_.load_config =
+	    std::chrono::steady_clock::now() - construction_start_;
+
+	if (options_.skip_unmatched_sends && !MatchingStatusCache::isSupported()) {
+		spdlog::warn(
+		    "ZenohUTransport: skip_unmatched_sends needs zenoh's unstable "
+		    "API, which this build of zenoh lacks. All messages are sent.");
+	}
+
+	if (options_.record_file.has_value()) {
+		recorder_ = std::make_unique<TrafficRecorder>(
+		    *options_.record_file, options_.record_capacity);
+	}
+
+	if (options_.receive_scheduler.has_value()) {
+		receive_scheduler_ =
+		    std::make_unique<ReceiveScheduler>(*options_.receive_scheduler);
+	}
+
+	if (options_.slow_listener_watchdog.has_value()) {
+		listener_watchdog_ = std::make_unique<ListenerWatchdog>(
+		    *options_.slow_listener_watchdog);
+		if (options_.slow_listener_watchdog->offload) {
+			offload_executor_ =
+			    std::make_unique<ReceiveScheduler>(ReceiveScheduler::Config{});
+		}
+	}
+
+	if (!options_.shaping_rules.empty()) {
+		traffic_shaper_ =
+		    std::make_unique<TrafficShaper>(options_.shaping_rules);
+	}
+
+	if (!options_.conflated_topics.empty()) {
+		std::map<std::string, std::chrono::milliseconds> intervals;
+		for (const auto& conflated : options_.conflated_topics) {
+			intervals[toZenohKeyString(default_uri.authority_name(),
+			                           conflated.topic, {})] =
+			    conflated.min_interval;
+		}
+		send_conflator_ = std::make_unique<SendConflator>(
+		    intervals,
+		    [this](const std::string& zenoh_key, const v1::UMessage& message) {
+			    auto status = sendKeyed_(zenoh_key, message);
+			    if (status.code() != v1::UCode::OK) {
+				    spdlog::warn("Conflated send on {} failed: {}", zenoh_key,
+				                 status.message());
+			    }
+		    });
+	}
+
+	if (!options_.open_session_async) {
+		openSession_(std::move(config), std::move(send_configs));
+		return;
+	}
+
+	startup_thread_ = std::thread(
+	    [this, config = std::move(config),
+	     send_configs = std::move(send_configs)]() mutable {
+		    // Any exception escaping this thread would terminate the
+		    // process, and leave waitUntilOpen() waiting until then.
+		    try {
+			    openSession_(std::move(config), std::move(send_configs));
+		    } catch (const std::exception& e) {
+			    // Including zenoh::ZException
+			    failOpen_(e.what());
+		    } catch (...) {
+			    failOpen_("unknown exception");
+		    }
+	    });
+}
+
+void ZenohUTransport::failOpen_(std::string_view reason) {
+	spdlog::error("ZenohUTransport: failed to open session: {}", reason);
+	std::lock_guard<std::mutex> lock(startup_mutex_);
+	startup_queue_.clear();
+	startup_state_.store(StartupState::FAILED, std::memory_order_release);
+	startup_cv_.notify_all();
+}
+
+ZenohUTransport::~ZenohUTransport() {
+	{
+		// Nothing queued should be sent by a transport being destroyed
+		std::lock_guard<std::mutex> lock(startup_mutex_);
+		startup_queue_.clear();
+	}
+	if (startup_thread_.joinable()) {
+		startup_thread_.join();
+	}
+
+	// Response callbacks use the response table, which is destroyed first
+	std::map<std::string, ResponseSubscriber> response_subscribers;
+	{
+		std::lock_guard<std::mutex> lock(response_subscribers_mutex_);
+		response_subscribers.swap(response_subscribers_);
+	}
+}
+
+void ZenohUTransport::openSession_(
+    zenoh::Config&& config, std::vector<zenoh::Config>&& send_configs) {
+	using std::chrono::steady_clock;
+	const auto open_start = steady_clock::now();
+	session_.emplace(zenoh::Session::open(std::move(config)));
+	for (auto& send_config : send_configs) {
+		send_sessions_.push_back(zenoh::Session::open(std::move(send_config)));
+	}
+	const auto declare_start = steady_clock::now();
+
+	if (options_.skip_unmatched_sends && MatchingStatusCache::isSupported()) {
+		matching_status_ = std::make_unique<MatchingStatusCache>(
+		    *session_, options_.max_matching_status_keys);
+	}
+
+	if (!options_.last_value_topics.empty()) {
+		declareLastValueQueryables_();
+	}
+	const auto replay_start = steady_clock::now();
+
+	// Operations are replayed without holding the lock, as they may call
+	// back into the transport (e.g. a listener sending a response). Any
+	// operation queued meanwhile runs in the next batch, and the state
+	// changes under the lock once the queue is empty, so none are left
+	// behind or reordered.
+	std::unique_lock<std::mutex> lock(startup_mutex_);
+	while (!startup_queue_.empty()) {
+		auto batch = std::move(startup_queue_);
+		startup_queue_.clear();
+		lock.unlock();
+		for (auto& operation : batch) {
+			operation.run();
+		}
+		lock.lock();
+	}
+
+	const auto open_end = steady_clock::now();
+	startup_timings_.open_session = declare_start - open_start;
+	startup_timings_.declare = replay_start - declare_start;
+	startup_timings_.replay = open_end - replay_start;
+	startup_timings_.until_open = open_end - construction_start_;
+	startup_state_.store(StartupState::OPEN, std::memory_order_release);
+	startup_cv_.notify_all();
 
 	spdlog::info("ZenohUTransport init");
 }
 
+v1::UStatus ZenohUTransport::runWhenOpen_(
+    std::function<v1::UStatus()>&& operation,
+    std::optional<CallableConn> listener) {
+	if (!isOpen_()) {
+		std::lock_guard<std::mutex> lock(startup_mutex_);
+		switch (startup_state_.load(std::memory_order_acquire)) {
+			case StartupState::OPEN:
+				break;
+			case StartupState::FAILED:
+				return uError(v1::UCode::UNAVAILABLE,
+				              "Zenoh session failed to open");
+			case StartupState::OPENING:
+				if (startup_queue_.size() >=
+				    options_.max_queued_while_opening) {
+					return uError(v1::UCode::RESOURCE_EXHAUSTED,
+					              "Too many operations queued while the "
+					              "zenoh session is opening");
+				}
+				startup_queue_.push_back(
+				    {[operation = std::move(operation)]() {
+					     auto status = operation();
+					     if (status.code() != v1::UCode::OK) {
+						     spdlog::warn(
+						         "Operation queued while opening failed: {}",
+						         status.message());
+					     }
+				     },
+				     std::move(listener)});
+				return {};
+		}
+	}
+	return operation();
+}
+
+bool ZenohUTransport::waitUntilOpen(std::chrono::milliseconds timeout) const {
+	std::unique_lock<std::mutex> lock(startup_mutex_);
+	startup_cv_.wait_for(lock, timeout, [this]() {
+		return startup_state_.load() != StartupState::OPENING;
+	});
+	return isOpen_();
+}
+
+void ZenohUTransport::noteFirst_(std::atomic<int64_t>& first_ns) const {
+	if (first_ns.load(std::memory_order_relaxed) != 0) {
+		return;
+	}
+	// Never 0, which means "not yet"
+	const auto elapsed = std::max<int64_t>(
+	    1, std::chrono::duration_cast<std::chrono::nanoseconds>(
+	           std::chrono::steady_clock::now() - construction_start_)
+	           .count());
+	int64_t unset = 0;
+	first_ns.compare_exchange_strong(unset, elapsed,
+	                                 std::memory_order_relaxed);
+}
+
+ZenohUTransport::StartupTimings ZenohUTransport::getStartupTimings() const {
+	StartupTimings timings;
+	{
+		std::lock_guard<std::mutex> lock(startup_mutex_);
+		timings = startup_timings_;
+	}
+	auto first = [](const std::atomic<int64_t>& first_ns)
+	    -> std::optional<std::chrono::nanoseconds> {
+		const auto ns = first_ns.load(std::memory_order_relaxed);
+		if (ns == 0) {
+			return std::nullopt;
+		}
+		return std::chrono::nanoseconds(ns);
+	};
+	timings.until_first_send = first(first_send_ns_);
+	timings.until_first_delivery = first(first_delivery_ns_);
+	return timings;
+}
+
+void ZenohUTransport::declareLastValueQueryables_() {
+	for (const auto& topic : options_.last_value_topics) {
+		auto zenoh_key =
+		    toZenohKeyString(getEntityUri().authority_name(), topic, {});
+		auto& last_value = last_values_[zenoh_key];
+
+		auto on_query = [zenoh_key, &last_value](const zenoh::Query& query) {
+			std::shared_ptr<const v1::UMessage> message;
+			{
+				std::lock_guard<std::mutex> lock(last_value.mutex);
+				message = last_value.message;
+			}
+			if (!message) {
+				return;
+			}
+
+			try {
+				zenoh::Query::ReplyOptions options;
+				options.encoding = zenoh::Encoding("app/custom");
+				options.attachment = zenoh::ext::serialize(
+				    uattributesToAttachment(message->attributes()));
+
+				const auto& payload = message->payload();
+				const std::vector<uint8_t> payload_as_bytes(payload.begin(),
+				                                            payload.end());
+				query.reply(zenoh::KeyExpr(zenoh_key),
+				            zenoh::ext::serialize(payload_as_bytes),
+				            std::move(options));
+			} catch (const zenoh::ZException& e) {
+				spdlog::error("on_query: Error when replying on {}: {}",
+				              zenoh_key, e.what());
+			}
+		};
+
+		// Throws if the queryable can't be declared, like a failure to open
+		// the session would.
+		last_value_queryables_.push_back(session_->declare_queryable(
+		    zenoh_key, std::move(on_query), []() {}));
+	}
+}
+
+std::string ZenohUTransport::responseKey_(const v1::UUri& requester) {
+	// Responses to this requester can come from any method on any entity
+	v1::UUri any_method;
+	any_method.set_authority_name("*");
+	any_method.set_ue_id(WILDCARD_ENTITY_ID);
+	any_method.set_ue_version_major(WILDCARD_ENTITY_VERSION);
+	any_method.set_resource_id(WILDCARD_RESOURCE_ID);
+	return toZenohKeyString(getEntityUri().authority_name(), any_method,
+	                        requester);
+}
+
+v1::UStatus ZenohUTransport::declareResponseSubscriber_(
+    const std::string& zenoh_key) {
+	std::lock_guard<std::mutex> lock(response_subscribers_mutex_);
+	auto it = response_subscribers_.find(zenoh_key);
+	// Calls queued while opening may all have expired by now
+	if ((it == response_subscribers_.end()) ||
+	    it->second.subscriber.has_value()) {
+		return {};
+	}
+
+	try {
+		it->second.subscriber = session_->declare_subscriber(
+		    zenoh_key,
+		    [this](const zenoh::Sample& sample) { handleResponse_(sample); },
+		    []() {});
+	} catch (const zenoh::ZException& e) {
+		spdlog::error(
+		    "declareResponseSubscriber_: Error when declaring subscriber: {}",
+		    e.what());
+		return uError(v1::UCode::INTERNAL, e.what());
+	}
+	return {};
+}
+
+void ZenohUTransport::releaseResponseSubscriber_(
+    const std::string& zenoh_key) {
+	std::optional<zenoh::Subscriber<void>> unused;
+	{
+		std::lock_guard<std::mutex> lock(response_subscribers_mutex_);
+		auto it = response_subscribers_.find(zenoh_key);
+		if ((it == response_subscribers_.end()) ||
+		    (--it->second.in_flight > 0)) {
+			return;
+		}
+		unused.swap(it->second.subscriber);
+		response_subscribers_.erase(it);
+	}
+	// NOTE: This may run in the subscriber's own callback. Zenoh keeps the
+	// running callback alive until it returns.
+}
+
+void ZenohUTransport::measurePublishToDelivery_(const zenoh::Sample& sample) {
+	const auto timestamp = sample.get_timestamp();
+	if (!timestamp.has_value()) {
+		return;
+	}
+	publish_to_delivery_.add(
+	    sample.get_keyexpr().as_string_view(),
+	    std::chrono::system_clock::now() - fromNtp64(timestamp->get_time()));
+}
+
+void ZenohUTransport::handleResponse_(const zenoh::Sample& sample) {
+	const auto delivered = std::chrono::steady_clock::now();
+	if (options_.measure_latency) {
+		measurePublishToDelivery_(sample);
+	}
+
+	v1::UMessage message;
+	if (!sampleToUAttributes(sample, *message.mutable_attributes()) ||
+	    (message.attributes().type() !=
+	     v1::UMessageType::UMESSAGE_TYPE_RESPONSE) ||
+	    (options_.drop_expired_on_receive && isExpired(message.attributes()))) {
+		return;
+	}
+
+	// Responses nobody waits for here, such as those for requests sent
+	// through send(), are not decoded any further.
+	auto handler = response_table_.take(message.attributes().reqid(),
+	                                    message.attributes().source());
+	if (!handler.has_value()) {
+		return;
+	}
+	samplePayloadToUMessage(sample, message);
+	if (recorder_) {
+		recorder_->record(TrafficRecorder::Direction::RECEIVED, message);
+	}
+	(*handler)(std::move(message));
+	noteFirst_(first_delivery_ns_);
+	if (options_.measure_latency) {
+		delivery_to_callback_.add(sample.get_keyexpr().as_string_view(),
+		                          std::chrono::steady_clock::now() - delivered);
+	}
+}
+
+v1::UStatus ZenohUTransport::invokeMethod(const v1::UMessage& request,
+                                          ResponseTable::Handler&& handler) {
+	const auto& attributes = request.attributes();
+	if ((attributes.type() != v1::UMessageType::UMESSAGE_TYPE_REQUEST) ||
+	    !attributes.has_ttl() || (attributes.ttl() == 0)) {
+		return uError(v1::UCode::INVALID_ARGUMENT,
+		              "invokeMethod requires a request with a TTL");
+	}
+
+	auto zenoh_key = responseKey_(attributes.source());
+	{
+		std::lock_guard<std::mutex> lock(response_subscribers_mutex_);
+		++response_subscribers_[zenoh_key].in_flight;
+	}
+
+	auto status = runWhenOpen_([this, zenoh_key]() {
+		return declareResponseSubscriber_(zenoh_key);
+	});
+	if (status.code() != v1::UCode::OK) {
+		releaseResponseSubscriber_(zenoh_key);
+		return status;
+	}
+
+	auto on_done = [this, zenoh_key, handler = std::move(handler)](
+	                   ResponseTable::ResponseOrStatus response_or_status) {
+		handler(std::move(response_or_status));
+		releaseResponseSubscriber_(zenoh_key);
+	};
+	if (!response_table_.expect(attributes.id(), attributes.sink(),
+	                            std::chrono::milliseconds(attributes.ttl()),
+	                            std::move(on_done))) {
+		releaseResponseSubscriber_(zenoh_key);
+		return uError(v1::UCode::ALREADY_EXISTS,
+		              "A request with this id is already in flight");
+	}
+
+	status = send(request);
+	if (status.code() != v1::UCode::OK) {
+		// The handler is dropped without being called
+		if (response_table_.take(attributes.id()).has_value()) {
+			releaseResponseSubscriber_(zenoh_key);
+		}
+	}
+	return status;
+}
+
+void ZenohUTransport::fetchLastValue_(const std::string& zenoh_key,
+                                      CallableConn listener) {
+	// NOTE: Replies may arrive while the transport is being destroyed, so
+	// the callback must not use any members.
+	const bool drop_expired = options_.drop_expired_on_receive;
+	auto on_reply = [listener = std::move(listener),
+	                 drop_expired](const zenoh::Reply& reply) mutable {
+		if (!reply.is_ok()) {
+			return;
+		}
+		const auto& sample = reply.get_ok();
+		v1::UMessage message;
+		if (!sampleToUAttributes(sample, *message.mutable_attributes()) ||
+		    (drop_expired && isExpired(message.attributes()))) {
+			return;
+		}
+		samplePayloadToUMessage(sample, message);
+		listener(message);
+	};
+
+	try {
+		zenoh::Session::GetOptions options;
+		session_->get(zenoh::KeyExpr(zenoh_key), "", std::move(on_reply),
+		             []() {}, std::move(options));
+	} catch (const zenoh::ZException& e) {
+		spdlog::warn("fetchLastValue_: Error when querying {}: {}", zenoh_key,
+		             e.what());
+	}
+}
+
+zenoh::Subscriber<void> ZenohUTransport::declareSubscriber_(
+    const std::string& zenoh_key,
+    std::shared_ptr<Registry::ListenerSet> listeners) {
+	// NOTE: listeners are shared with the registry, which adds and removes
+	// listeners on this key without declaring a new subscriber.
+	// Each subscriber has its own filter, as a duplicate of a message
+	// must still reach the listeners of other matching keys.
+	std::shared_ptr<DuplicateFilter> duplicates;
+	if (options_.suppress_duplicates) {
+		duplicates =
+		    std::make_shared<DuplicateFilter>(*options_.suppress_duplicates);
+	}
+
+	auto on_sample = [this, listeners = std::move(listeners),
+	                  duplicates = std::move(duplicates)](
+	                     const zenoh::Sample& sample) {
+		handleSample_(sample, *listeners, duplicates.get());
+	};
+
+	auto on_drop = []() {};
+
+	return session_->declare_subscriber(zenoh_key, std::move(on_sample),
+	                                   std::move(on_drop));
+}
+
 v1::UStatus ZenohUTransport::registerPublishNotificationListener_(
     const std::string& zenoh_key, CallableConn listener) {
 	spdlog::info("registerPublishNotificationListener_: {}", zenoh_key);
 
-	// NOTE: listener is captured by copy here so that it does not go out
-	// of scope when this function returns.
-	auto on_sample = [listener](const zenoh::Sample& sample) mutable {
-		auto maybe_message = sampleToUMessage(sample);
-		if (maybe_message.has_value()) {
-			listener(maybe_message.value());
-		} else {
-			spdlog::error("on_sample: failed to retrieve uMessage");
+	std::vector<std::pair<std::string, Registry::Listeners>> group;
+	group.emplace_back(zenoh_key, Registry::Listeners{listener});
+	if (subscriber_registry_.attach(group).front()) {
+		return {};
+	}
+
+	try {
+		auto listeners = std::make_shared<Registry::ListenerSet>(
+		    std::move(group.front().second));
+		auto subscriber = declareSubscriber_(zenoh_key, listeners);
+
+		std::vector<Registry::Entry> entries;
+		entries.push_back(
+		    {zenoh_key, std::move(listeners), std::move(subscriber)});
+		// A surplus subscriber, if another one was declared on this key
+		// concurrently, is dropped on return.
+		subscriber_registry_.insert(std::move(entries));
+	} catch (const zenoh::ZException& e) {
+		spdlog::error(
+		    "registerPublishNotificationListener_: Error when declaring "
+		    "subscriber: {}",
+		    e.what());
+		return uError(v1::UCode::INTERNAL, e.what());
+	}
+	return {};
+}
+
+std::vector<ZenohUTransport::RegistrationResult>
+ZenohUTransport::registerListeners(
+    std::vector<ListenerRegistration>&& registrations) {
+	using CallbackConnection =
+	    utils::callbacks::Connection<void, const v1::UMessage&>;
+	using datamodel::validator::uri::isValidFilter;
+	constexpr size_t MAX_DECLARE_WORKERS = 8;
+	// Starting a thread costs more than declaring a few subscribers, so
+	// each worker gets at least this many
+	constexpr size_t MIN_DECLARES_PER_WORKER = 64;
+
+	// Until the session is open, registrations are queued one by one
+	if (!isOpen_()) {
+		std::vector<RegistrationResult> results;
+		for (auto& registration : registrations) {
+			results.push_back(registerListener(
+			    std::move(registration.callback), registration.source_filter,
+			    std::move(registration.sink_filter)));
+		}
+		return results;
+	}
+
+	std::vector<v1::UStatus> statuses(registrations.size());
+	std::vector<ListenHandle> handles(registrations.size());
+	std::vector<std::pair<std::string, std::optional<CallableConn>>>
+	    last_value_fetches(registrations.size());
+
+	// Compute each key once and group the listeners by key
+	std::map<std::string, std::pair<Registry::Listeners, std::vector<size_t>>>
+	    by_key;
+	for (size_t index = 0; index < registrations.size(); ++index) {
+		auto& registration = registrations[index];
+
+		const bool valid =
+		    std::get<0>(isValidFilter(registration.source_filter)) &&
+		    (!registration.sink_filter.has_value() ||
+		     std::get<0>(isValidFilter(*registration.sink_filter)));
+		if (!valid) {
+			statuses[index] =
+			    uError(v1::UCode::INVALID_ARGUMENT, "Invalid filter");
+			continue;
+		}
+
+		auto [handle, callable] = CallbackConnection::establish(
+		    std::move(registration.callback),
+		    [this](const auto& conn) { cleanupListener(conn); });
+		handles[index] = std::move(handle);
+		if (listener_watchdog_) {
+			listener_watchdog_->watch(callable, registration.source_filter,
+			                          registration.sink_filter);
+		}
+
+		auto zenoh_key = toZenohKeyString(getEntityUri().authority_name(),
+		                                  registration.source_filter,
+		                                  registration.sink_filter);
+		if (options_.fetch_last_value_on_register &&
+		    !registration.sink_filter.has_value()) {
+			last_value_fetches[index] = {zenoh_key, callable};
+		}
+
+		auto& group = by_key[zenoh_key];
+		group.first.push_back(std::move(callable));
+		group.second.push_back(index);
+	}
+
+	std::vector<std::pair<std::string, Registry::Listeners>> groups;
+	std::vector<std::vector<size_t>> group_indices;
+	groups.reserve(by_key.size());
+	group_indices.reserve(by_key.size());
+	for (auto& [key, group] : by_key) {
+		groups.emplace_back(key, std::move(group.first));
+		group_indices.push_back(std::move(group.second));
+	}
+
+	// Keys that already have a subscriber only need their listeners added
+	const auto attached = subscriber_registry_.attach(groups);
+	std::vector<size_t> to_declare;
+	for (size_t group = 0; group < groups.size(); ++group) {
+		if (!attached[group]) {
+			to_declare.push_back(group);
+		}
+	}
+
+	// Declare the remaining subscribers in parallel
+	std::vector<std::optional<Registry::Entry>> entries(to_declare.size());
+	std::atomic<size_t> next = 0;
+	auto declare_worker = [&]() {
+		for (size_t slot = next++; slot < to_declare.size(); slot = next++) {
+			auto& [key, listeners] = groups[to_declare[slot]];
+			try {
+				auto listener_set =
+				    std::make_shared<Registry::ListenerSet>(listeners);
+				auto subscriber = declareSubscriber_(key, listener_set);
+				entries[slot].emplace(Registry::Entry{
+				    key, std::move(listener_set), std::move(subscriber)});
+			} catch (const zenoh::ZException& e) {
+				spdlog::error(
+				    "registerListeners: Error when declaring subscriber for "
+				    "{}: {}",
+				    key, e.what());
+				for (auto index : group_indices[to_declare[slot]]) {
+					statuses[index] = uError(v1::UCode::INTERNAL, e.what());
+				}
+			}
 		}
 	};
+	const size_t num_workers =
+	    std::min({to_declare.size() / MIN_DECLARES_PER_WORKER,
+	              MAX_DECLARE_WORKERS,
+	              static_cast<size_t>(std::thread::hardware_concurrency())});
+	std::vector<std::thread> workers;
+	for (size_t worker = 1; worker < num_workers; ++worker) {
+		workers.emplace_back(declare_worker);
+	}
+	declare_worker();
+	for (auto& worker : workers) {
+		worker.join();
+	}
 
-	auto on_drop = []() {};
+	// Insert all new subscribers under a single registry lock
+	std::vector<Registry::Entry> declared;
+	declared.reserve(entries.size());
+	for (auto& entry : entries) {
+		if (entry.has_value()) {
+			declared.push_back(std::move(*entry));
+		}
+	}
+	subscriber_registry_.insert(std::move(declared));
 
-	auto subscriber = session_.declare_subscriber(
-	    zenoh_key, std::move(on_sample), std::move(on_drop));
-	subscriber_map_.emplace(listener, std::move(subscriber));
-	return {};
+	std::vector<RegistrationResult> results;
+	results.reserve(registrations.size());
+	for (size_t index = 0; index < registrations.size(); ++index) {
+		if (statuses[index].code() == v1::UCode::OK) {
+			auto& [zenoh_key, last_value_listener] = last_value_fetches[index];
+			if (last_value_listener.has_value()) {
+				fetchLastValue_(zenoh_key, std::move(*last_value_listener));
+			}
+			results.emplace_back(std::move(handles[index]));
+		} else {
+			results.emplace_back(
+			    utils::Unexpected<v1::UStatus>(std::move(statuses[index])));
+		}
+	}
+	return results;
+}
+
+void ZenohUTransport::handleSample_(const zenoh::Sample& sample,
+                                    const Registry::ListenerSet& listener_set,
+                                    DuplicateFilter* duplicates) {
+	const auto delivered = std::chrono::steady_clock::now();
+	if (options_.measure_latency) {
+		measurePublishToDelivery_(sample);
+	}
+
+	v1::UMessage message;
+	if (!sampleToUAttributes(sample, *message.mutable_attributes())) {
+		spdlog::error("on_sample: failed to retrieve uAttributes");
+		return;
+	}
+
+	if ((duplicates != nullptr) &&
+	    duplicates->isDuplicate(message.attributes().id())) {
+		duplicates_on_receive_.increment(
+		    sample.get_keyexpr().as_string_view());
+		return;
+	}
+
+	const bool drop_expired = options_.drop_expired_on_receive;
+	if (drop_expired && isExpired(message.attributes())) {
+		expired_on_receive_.increment(sample.get_keyexpr().as_string_view());
+		spdlog::debug("on_sample: dropping expired message on {}",
+		              sample.get_keyexpr().as_string_view());
+		return;
+	}
+
+	samplePayloadToUMessage(sample, message);
+	if (recorder_) {
+		recorder_->record(TrafficRecorder::Direction::RECEIVED, message);
+	}
+	const auto listeners = listener_set.get();
+
+	if (!receive_scheduler_) {
+		for (auto& listener : *listeners) {
+			invokeListener_(listener, message,
+			                sample.get_keyexpr().as_string_view(), delivered);
+		}
+		return;
+	}
+
+	const auto priority = message.attributes().priority();
+	auto shared_key = std::make_shared<const std::string>(
+	    sample.get_keyexpr().as_string_view());
+	auto shared_message =
+	    std::make_shared<const v1::UMessage>(std::move(message));
+	for (auto& listener : *listeners) {
+		// Messages can also expire while they are queued
+		auto dispatch = [this, listener, drop_expired, delivered, shared_key,
+		                 shared_message]() mutable {
+			if (drop_expired && isExpired(shared_message->attributes())) {
+				expired_on_receive_.increment(*shared_key);
+				return;
+			}
+			invokeListener_(listener, *shared_message, *shared_key,
+			                delivered);
+		};
+		if (!receive_scheduler_->post(priority, std::move(dispatch))) {
+			spdlog::warn("on_sample: receive queue for priority {} is full",
+			             static_cast<int>(priority));
+		}
+	}
+}
+
+void ZenohUTransport::noteDelivered_(
+    std::string_view zenoh_key,
+    std::chrono::steady_clock::time_point delivered) {
+	noteFirst_(first_delivery_ns_);
+	if (options_.measure_latency) {
+		delivery_to_callback_.add(zenoh_key,
+		                          std::chrono::steady_clock::now() - delivered);
+	}
+}
+
+void ZenohUTransport::invokeListener_(
+    CallableConn& listener, const v1::UMessage& message,
+    std::string_view zenoh_key,
+    std::chrono::steady_clock::time_point delivered) {
+	if (!listener_watchdog_) {
+		listener(message);
+		noteDelivered_(zenoh_key, delivered);
+		return;
+	}
+
+	if (offload_executor_ && listener_watchdog_->isOffloaded(listener)) {
+		auto offloaded = [this, listener, message,
+		                  zenoh_key = std::string(zenoh_key),
+		                  delivered]() mutable {
+			listener(message);
+			noteDelivered_(zenoh_key, delivered);
+		};
+		if (!offload_executor_->post(message.attributes().priority(),
+		                             std::move(offloaded))) {
+			spdlog::warn("on_sample: offload queue is full, dropping message "
+			             "on {}",
+			             zenoh_key);
+		}
+		return;
+	}
+
+	const auto start = std::chrono::steady_clock::now();
+	listener(message);
+	const auto duration = std::chrono::steady_clock::now() - start;
+	noteDelivered_(zenoh_key, delivered);
+	if (auto slow = listener_watchdog_->check(zenoh_key, listener, duration)) {
+		spdlog::warn(
+		    "on_sample: listener {} on {} took {}us{}", slow->listener_id,
+		    zenoh_key,
+		    std::chrono::duration_cast<std::chrono::microseconds>(duration)
+		        .count(),
+		    slow->offloaded ? ", its calls are now run off this thread" : "");
+	}
+}
+
+size_t ZenohUTransport::sendSessionIndex(const std::string& zenoh_key,
+                                         size_t num_sessions) {
+	return std::hash<std::string>{}(zenoh_key) % num_sessions;
+}
+
+zenoh::Session& ZenohUTransport::sendSessionFor_(
+    const std::string& zenoh_key) {
+	if (send_sessions_.empty()) {
+		return *session_;
+	}
+	const size_t session =
+	    sendSessionIndex(zenoh_key, send_sessions_.size() + 1);
+	return (session == 0) ? *session_ : send_sessions_[session - 1];
 }
 
 v1::UStatus ZenohUTransport::sendPublishNotification_(
@@ -237,7 +1092,70 @@ v1::UStatus ZenohUTransport::sendPublishNotification_(
     const v1::UAttributes& attributes) {
 	spdlog::debug("sendPublishNotification_: {}: {}", zenoh_key, payload);
 	auto attachment = uattributesToAttachment(attributes);
-	auto priority = mapZenohPriority(attributes.priority());
+	const std::vector<uint8_t> payload_as_bytes(payload.begin(),
+	                                            payload.end());
+	const bool bulk = isBulk_(zenoh_key, payload.size(), attributes.type());
+	return put_(zenoh_key, zenoh::ext::serialize(payload_as_bytes),
+	            zenoh::ext::serialize(attachment),
+	            mapZenohPriority(attributes.priority()), bulk);
+}
+
+bool ZenohUTransport::isBulk_(const std::string& zenoh_key,
+                              size_t payload_size, v1::UMessageType type) {
+	if (!options_.large_payload_lane.has_value() ||
+	    !isPublishOrNotification(type)) {
+		return false;
+	}
+	const auto& lane = *options_.large_payload_lane;
+	const bool large = payload_size >= lane.min_size;
+	if (!large && (num_bulk_keys_.load(std::memory_order_relaxed) == 0)) {
+		return false;
+	}
+
+	// Once a key has sent a large payload, its messages stay in the bulk
+	// lane until it has been quiet for a while, so that they can't
+	// overtake each other.
+	const auto now = std::chrono::steady_clock::now();
+	std::lock_guard<std::mutex> lock(bulk_keys_mutex_);
+	if (large) {
+		const bool inserted =
+		    bulk_keys_.insert_or_assign(zenoh_key, now).second;
+		if (inserted && (bulk_keys_.size() >= bulk_keys_sweep_size_)) {
+			for (auto it = bulk_keys_.begin(); it != bulk_keys_.end();) {
+				if (now - it->second >= lane.quiet_period) {
+					it = bulk_keys_.erase(it);
+				} else {
+					++it;
+				}
+			}
+			bulk_keys_sweep_size_ =
+			    std::max(bulk_keys_sweep_size_, 2 * bulk_keys_.size());
+		}
+		num_bulk_keys_.store(bulk_keys_.size(), std::memory_order_relaxed);
+		return true;
+	}
+
+	auto it = bulk_keys_.find(zenoh_key);
+	if (it == bulk_keys_.end()) {
+		return false;
+	}
+	if (now - it->second < lane.quiet_period) {
+		return true;
+	}
+	bulk_keys_.erase(it);
+	num_bulk_keys_.store(bulk_keys_.size(), std::memory_order_relaxed);
+	return false;
+}
+
+v1::UStatus ZenohUTransport::put_(const std::string& zenoh_key,
+                                  zenoh::Bytes&& payload,
+                                  zenoh::Bytes&& attachment,
+                                  zenoh::Priority priority, bool bulk) {
+	if (bulk) {
+		bulk_lane_sends_.increment(zenoh_key);
+		// Higher values are lower priorities
+		priority = std::max(priority, options_.large_payload_lane->priority);
+	}
 
 	try {
 		// -Wpedantic disallows named member initialization until C++20,
@@ -246,18 +1164,20 @@ v1::UStatus ZenohUTransport::sendPublishNotification_(
 		zenoh::Session::PutOptions options;
 		options.priority = priority;
 		options.encoding = zenoh::Encoding("app/custom");
-		options.attachment = zenoh::ext::serialize(attachment);
-
-		const std::vector<uint8_t> payload_as_bytes(payload.begin(),
-		                                            payload.end());
-		session_.put(zenoh::KeyExpr(zenoh_key),
-		             zenoh::ext::serialize(payload_as_bytes),
-		             std::move(options));
-		spdlog::debug("sendPublishNotification_: sent successfully.");
+		options.attachment = std::move(attachment);
+
+		// Timestamps come from the session doing the put, whose clock
+		// and id they carry
+		auto& session = sendSessionFor_(zenoh_key);
+		if (options_.measure_latency) {
+			options.timestamp = session.new_timestamp();
+		}
+		session.put(zenoh::KeyExpr(zenoh_key), std::move(payload),
+		            std::move(options));
+		noteFirst_(first_send_ns_);
+		spdlog::debug("put_: sent successfully.");
 	} catch (const zenoh::ZException& e) {
-		spdlog::error(
-		    "sendPublishNotification_: Error when sending message: {}",
-		    e.what());
+		spdlog::error("put_: Error when sending message: {}", e.what());
 		return uError(v1::UCode::INTERNAL, e.what());
 	}
 
@@ -267,8 +1187,18 @@ v1::UStatus ZenohUTransport::sendPublishNotification_(
 // NOTE: Messages have already been validated by the base class. It does not
 // need to be re-checked here.
 v1::UStatus ZenohUTransport::sendImpl(const v1::UMessage& message) {
-	const auto& payload = message.payload();
+	if (recorder_) {
+		recorder_->record(TrafficRecorder::Direction::SENT, message);
+	}
 
+	if (!isOpen_()) {
+		return runWhenOpen_(
+		    [this, message]() { return conflateAndSend_(message); });
+	}
+	return conflateAndSend_(message);
+}
+
+v1::UStatus ZenohUTransport::conflateAndSend_(const v1::UMessage& message) {
 	const auto& attributes = message.attributes();
 
 	std::string zenoh_key;
@@ -280,7 +1210,171 @@ v1::UStatus ZenohUTransport::sendImpl(const v1::UMessage& message) {
 		                             attributes.source(), attributes.sink());
 	}
 
-	return sendPublishNotification_(zenoh_key, payload, attributes);
+	if (send_conflator_ && (send_conflator_->offer(zenoh_key, message) ==
+	                        SendConflator::Action::DEFERRED)) {
+		return {};
+	}
+
+	return sendKeyed_(zenoh_key, message);
+}
+
+v1::UStatus ZenohUTransport::sendKeyed_(const std::string& zenoh_key,
+                                        const v1::UMessage& message) {
+	const auto& attributes = message.attributes();
+
+	if (options_.drop_expired_on_send && isExpired(attributes)) {
+		expired_on_send_.increment(zenoh_key);
+		spdlog::debug("sendKeyed_: dropping expired message on {}", zenoh_key);
+		return uError(v1::UCode::DEADLINE_EXCEEDED, "Message TTL expired");
+	}
+
+	// Messages nobody would receive are not charged to the shaper
+	const bool unmatched = isUnmatched_(zenoh_key, attributes.type());
+	if (!unmatched) {
+		if (auto shaped = shape_(zenoh_key, message)) {
+			return *shaped;
+		}
+	}
+
+	// Late joiners must get the last value even if nobody is subscribed now
+	auto last_value = last_values_.find(zenoh_key);
+	if (last_value != last_values_.end()) {
+		auto latest = std::make_shared<const v1::UMessage>(message);
+		std::lock_guard<std::mutex> lock(last_value->second.mutex);
+		last_value->second.message = std::move(latest);
+	}
+
+	if (unmatched) {
+		unmatched_skips_.increment(zenoh_key);
+		return {};
+	}
+
+	return sendPublishNotification_(zenoh_key, message.payload(), attributes);
+}
+
+bool ZenohUTransport::isUnmatched_(const std::string& zenoh_key,
+                                   v1::UMessageType type) {
+	// RPC requests and responses always have a listener waiting for them,
+	// so only publish and notification messages are worth checking.
+	return matching_status_ && isPublishOrNotification(type) &&
+	       !matching_status_->hasSubscribers(zenoh_key);
+}
+
+std::optional<v1::UStatus> ZenohUTransport::shape_(
+    const std::string& zenoh_key, const v1::UMessage& message) {
+	if (!traffic_shaper_) {
+		return std::nullopt;
+	}
+	switch (traffic_shaper_->admit(zenoh_key, message)) {
+		case TrafficShaper::Decision::SEND:
+			break;
+		case TrafficShaper::Decision::DROP:
+			return v1::UStatus{};
+		case TrafficShaper::Decision::REJECT:
+			return uError(v1::UCode::RESOURCE_EXHAUSTED,
+			              "Send rate limit exceeded");
+	}
+	return std::nullopt;
+}
+
+std::vector<v1::UStatus> ZenohUTransport::sendToSinks(
+    const v1::UMessage& notification, const std::vector<v1::UUri>& sinks) {
+	using datamodel::validator::message::isValidNotification;
+	using datamodel::validator::uri::isValidNotificationSink;
+
+	std::vector<v1::UStatus> statuses(sinks.size());
+	if (sinks.empty()) {
+		return statuses;
+	}
+
+	// The notification is validated as a whole once, and then each sink
+	v1::UMessage first_notification;
+	*first_notification.mutable_attributes() = notification.attributes();
+	*first_notification.mutable_attributes()->mutable_sink() = sinks.front();
+	if (!std::get<0>(isValidNotification(first_notification))) {
+		statuses.assign(sinks.size(), uError(v1::UCode::INVALID_ARGUMENT,
+		                                     "Invalid notification"));
+		return statuses;
+	}
+
+	// Until the session is open, or when recording each message, the
+	// notification is sent once per sink.
+	if (!isOpen_() || recorder_) {
+		auto per_sink = notification;
+		for (size_t index = 0; index < sinks.size(); ++index) {
+			*per_sink.mutable_attributes()->mutable_sink() = sinks[index];
+			statuses[index] = send(per_sink);
+		}
+		return statuses;
+	}
+
+	const auto& authority = getEntityUri().authority_name();
+	std::ostringstream source_key;
+	source_key << "up";
+	writeUUriKey(source_key, authority, notification.attributes().source());
+	const auto key_prefix = source_key.str();
+
+	// Everything but the sink is encoded once. The payload is shared by
+	// all puts, and each attachment is the same attributes with only the
+	// sink inserted.
+	auto attributes = notification.attributes();
+	attributes.clear_sink();
+	std::vector<uint8_t> encoded(UAttributesCodec::encodedSize(attributes));
+	UAttributesCodec::encode(attributes, encoded.data());
+	const auto before_sink = static_cast<std::ptrdiff_t>(
+	    UAttributesCodec::encodedSizeBeforeSink(attributes));
+
+	const auto& payload = notification.payload();
+	const auto shared_payload = zenoh::ext::serialize(
+	    std::vector<uint8_t>(payload.begin(), payload.end()));
+	const size_t payload_size = payload.size();
+	const auto priority = mapZenohPriority(attributes.priority());
+	const bool expired = options_.drop_expired_on_send && isExpired(attributes);
+
+	auto attachment = uattributesToAttachment({});
+	auto& attachment_attributes = attachment.back().second;
+	for (size_t index = 0; index < sinks.size(); ++index) {
+		const auto& sink = sinks[index];
+		if (!std::get<0>(isValidNotificationSink(sink))) {
+			statuses[index] =
+			    uError(v1::UCode::INVALID_ARGUMENT, "Invalid sink");
+			continue;
+		}
+
+		std::ostringstream sink_key;
+		writeUUriKey(sink_key, authority, sink);
+		const auto zenoh_key = key_prefix + sink_key.str();
+
+		if (expired) {
+			expired_on_send_.increment(zenoh_key);
+			statuses[index] =
+			    uError(v1::UCode::DEADLINE_EXCEEDED, "Message TTL expired");
+			continue;
+		}
+		if (isUnmatched_(zenoh_key, notification.attributes().type())) {
+			unmatched_skips_.increment(zenoh_key);
+			continue;
+		}
+		if (auto shaped = shape_(zenoh_key, notification)) {
+			statuses[index] = std::move(*shaped);
+			continue;
+		}
+
+		attachment_attributes.resize(encoded.size() +
+		                             UAttributesCodec::encodedSinkSize(sink));
+		auto* out = std::copy(encoded.begin(), encoded.begin() + before_sink,
+		                      attachment_attributes.data());
+		out = UAttributesCodec::encodeSink(sink, out);
+		std::copy(encoded.begin() + before_sink, encoded.end(), out);
+
+		const bool bulk =
+		    isBulk_(zenoh_key, payload_size,
+		            v1::UMessageType::UMESSAGE_TYPE_NOTIFICATION);
+		statuses[index] =
+		    put_(zenoh_key, shared_payload.clone(),
+		         zenoh::ext::serialize(attachment), priority, bulk);
+	}
+	return statuses;
 }
 
 v1::UStatus ZenohUTransport::registerListenerImpl(
@@ -289,11 +1383,197 @@ v1::UStatus ZenohUTransport::registerListenerImpl(
 	std::string zenoh_key = toZenohKeyString(getEntityUri().authority_name(),
 	                                         source_filter, sink_filter);
 
-	return registerPublishNotificationListener_(zenoh_key, std::move(listener));
+	const bool fetch_last_value =
+	    options_.fetch_last_value_on_register && !sink_filter.has_value();
+	if (listener_watchdog_) {
+		listener_watchdog_->watch(listener, source_filter, sink_filter);
+	}
+
+	auto operation = [this, zenoh_key = std::move(zenoh_key), listener,
+	                  fetch_last_value]() -> v1::UStatus {
+		// A registration replayed once the session is open may be for a
+		// listener whose handle has been reset meanwhile
+		if (!listener) {
+			return {};
+		}
+		auto status = registerPublishNotificationListener_(zenoh_key, listener);
+		if (status.code() != v1::UCode::OK) {
+			return status;
+		}
+		if (!listener) {
+			// Disconnected while being registered, and possibly cleaned
+			// up before there was anything to clean up
+			subscriber_registry_.detach(listener);
+			return {};
+		}
+		if (fetch_last_value) {
+			fetchLastValue_(zenoh_key, listener);
+		}
+		return status;
+	};
+	return runWhenOpen_(std::move(operation), std::move(listener));
+}
+
+std::optional<v1::UStatus> ZenohUTransport::checkSubscription_(
+    const v1::UUri& source_filter, const std::optional<v1::UUri>& sink_filter,
+    size_t capacity) const {
+	using datamodel::validator::uri::isValidFilter;
+	const bool valid = std::get<0>(isValidFilter(source_filter)) &&
+	                   (!sink_filter.has_value() ||
+	                    std::get<0>(isValidFilter(*sink_filter)));
+	if (!valid) {
+		return uError(v1::UCode::INVALID_ARGUMENT, "Invalid filter");
+	}
+	if (capacity == 0) {
+		return uError(v1::UCode::INVALID_ARGUMENT, "Capacity must not be 0");
+	}
+	if (!isOpen_()) {
+		return uError(v1::UCode::UNAVAILABLE, "Zenoh session is not open");
+	}
+	return std::nullopt;
+}
+
+PullSubscription::Decoder ZenohUTransport::subscriptionDecoder_() const {
+	// NOTE: Subscriptions may outlive the transport, so the decoder must
+	// not use any members.
+	const bool drop_expired = options_.drop_expired_on_receive;
+	return [drop_expired](
+	           const zenoh::Sample& sample) -> std::optional<v1::UMessage> {
+		v1::UMessage message;
+		if (!sampleToUAttributes(sample, *message.mutable_attributes()) ||
+		    (drop_expired && isExpired(message.attributes()))) {
+			return std::nullopt;
+		}
+		samplePayloadToUMessage(sample, message);
+		return message;
+	};
+}
+
+ZenohUTransport::PullSubscriptionResult
+ZenohUTransport::createPullSubscription(
+    const v1::UUri& source_filter, const std::optional<v1::UUri>& sink_filter,
+    const PullSubscription::Config& config) {
+	if (auto error =
+	        checkSubscription_(source_filter, sink_filter, config.capacity)) {
+		return utils::Unexpected<v1::UStatus>(std::move(*error));
+	}
+
+	const auto zenoh_key = toZenohKeyString(getEntityUri().authority_name(),
+	                                        source_filter, sink_filter);
+
+	try {
+		return std::make_unique<PullSubscription>(
+		    *session_, zenoh_key, config, subscriptionDecoder_());
+	} catch (const zenoh::ZException& e) {
+		spdlog::error(
+		    "createPullSubscription: Error when declaring subscriber: {}",
+		    e.what());
+		return utils::Unexpected<v1::UStatus>(
+		    uError(v1::UCode::INTERNAL, e.what()));
+	}
+}
+
+ZenohUTransport::BatchSubscriptionResult
+ZenohUTransport::createBatchSubscription(
+    const v1::UUri& source_filter, const std::optional<v1::UUri>& sink_filter,
+    const BatchSubscription::Config& config,
+    BatchSubscription::Callback&& callback) {
+	if (auto error =
+	        checkSubscription_(source_filter, sink_filter, config.capacity)) {
+		return utils::Unexpected<v1::UStatus>(std::move(*error));
+	}
+	if ((config.max_batch == 0) || !callback) {
+		return utils::Unexpected<v1::UStatus>(uError(
+		    v1::UCode::INVALID_ARGUMENT,
+		    "Batch size must not be 0, and a callback must be given"));
+	}
+
+	const auto zenoh_key = toZenohKeyString(getEntityUri().authority_name(),
+	                                        source_filter, sink_filter);
+
+	try {
+		return std::make_unique<BatchSubscription>(
+		    *session_, zenoh_key, config, subscriptionDecoder_(),
+		    std::move(callback));
+	} catch (const zenoh::ZException& e) {
+		spdlog::error(
+		    "createBatchSubscription: Error when declaring subscriber: {}",
+		    e.what());
+		return utils::Unexpected<v1::UStatus>(
+		    uError(v1::UCode::INTERNAL, e.what()));
+	}
+}
+
+ZenohUTransport::ExpiredDrops ZenohUTransport::getExpiredDrops() const {
+	return {expired_on_send_.snapshot(), expired_on_receive_.snapshot()};
+}
+
+TopicCounters::Snapshot ZenohUTransport::getUnmatchedSkips() const {
+	return unmatched_skips_.snapshot();
+}
+
+TopicCounters::Snapshot ZenohUTransport::getSuppressedDuplicates() const {
+	return duplicates_on_receive_.snapshot();
+}
+
+TopicCounters::Snapshot ZenohUTransport::getBulkLaneSends() const {
+	return bulk_lane_sends_.snapshot();
+}
+
+TopicLatencies::Snapshot ZenohUTransport::getSlowListenerCalls() const {
+	if (!listener_watchdog_) {
+		return {};
+	}
+	return listener_watchdog_->slowCalls();
+}
+
+TopicCounters::Snapshot ZenohUTransport::getConflatedSends() const {
+	if (!send_conflator_) {
+		return {};
+	}
+	return send_conflator_->conflated();
+}
+
+ZenohUTransport::Latencies ZenohUTransport::getLatencies() const {
+	return {publish_to_delivery_.snapshot(), delivery_to_callback_.snapshot()};
+}
+
+std::vector<TrafficShaper::RuleStats> ZenohUTransport::getShapingStats()
+    const {
+	if (!traffic_shaper_) {
+		return {};
+	}
+	return traffic_shaper_->stats();
+}
+
+ZenohUTransport::RecordedTraffic ZenohUTransport::getRecordedTraffic() const {
+	if (!recorder_) {
+		return {0, 0};
+	}
+	return {recorder_->recorded(), recorder_->dropped()};
 }
 
 void ZenohUTransport::cleanupListener(const CallableConn& listener) {
-	subscriber_map_.erase(listener);
+	if (!isOpen_()) {
+		// A registration still queued must not be replayed
+		auto is_listener = [&listener](const QueuedOperation& operation) {
+			const std::less<CallableConn> less;
+			return operation.listener.has_value() &&
+			       !less(*operation.listener, listener) &&
+			       !less(listener, *operation.listener);
+		};
+		std::lock_guard<std::mutex> lock(startup_mutex_);
+		startup_queue_.erase(std::remove_if(startup_queue_.begin(),
+		                                    startup_queue_.end(), is_listener),
+		                     startup_queue_.end());
+	}
+
+	// If this was the last listener on its key, the returned subscriber is
+	// dropped (undeclared) here, after the registry lock has been released.
+	subscriber_registry_.detach(listener);
+	if (listener_watchdog_) {
+		listener_watchdog_->forget(listener);
+	}
 }
 
 }  // namespace uprotocol::transport
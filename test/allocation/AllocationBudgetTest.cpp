@@ -0,0 +1,196 @@
+// SPDX-FileCopyrightText: 2024 Contributors to the Eclipse Foundation
+//
+// See the NOTICE file(s) distributed with this work for additional
+// information regarding copyright ownership.
+//
+// This program and the accompanying materials are made available under the
+// terms of the Apache License Version 2.0 which is available at
+// https://www.apache.org/licenses/LICENSE-2.0
+//
+// SPDX-License-Identifier: Apache-2.0
+
+#include <gtest/gtest.h>
+
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+#include "AllocationCounter.h"
+#include "BenchmarkUtils.h"
+#include "LinkedConfigs.h"
+#include "up-transport-zenoh-cpp/ZenohUTransport.h"
+
+namespace uprotocol {
+
+constexpr uint32_t TX_ENTITY = 0x10001;
+constexpr uint32_t RX_ENTITY = 0x10002;
+constexpr uint16_t TOPIC = 0x8000;
+constexpr size_t WARMUP_MESSAGES = 100;
+constexpr size_t MEASURED_MESSAGES = 1000;
+constexpr auto CONNECT_DELAY = std::chrono::seconds(1);
+constexpr auto DELIVERY_TIMEOUT = std::chrono::seconds(10);
+
+// Budgets per call or message, in steady state. Each one is the measured
+// value plus a small margin: 2 allocations, and fixed bytes rounded up to
+// the next multiple of 256. Payload copies are exact. A failure means
+// allocations were added; lower the budget when a path gets cheaper.
+//
+// PROVISIONAL: these figures were measured with libstdc++ (GCC 12, -O2)
+// against an in-process loopback stand-in for zenoh and up-cpp, not
+// against real builds of either:
+//   - payload and attachment buffers that zenoh allocates with malloc
+//     were not counted;
+//   - up-cpp's message and URI validation was skipped, so whatever it
+//     allocates on send is missing.
+// They must be re-measured against real zenohcpp and up-cpp builds before
+// this test gates anything. Until then, it is only added to ctest with
+// -DRUN_ALLOCATION_BUDGETS=ON. Only allocations made through operator new
+// are counted:
+//   toZenohKeyString:  3 allocations, 583 bytes
+//   send:              9 allocations, 807 bytes + 1 payload copy
+//                      (8 allocations with an empty payload)
+//   receive:           7 allocations, 241 bytes + 2 payload copies
+//                      (4 allocations, 208 bytes with an empty payload)
+constexpr size_t KEY_ALLOCATIONS = 5;
+constexpr size_t KEY_BYTES = 768;
+constexpr size_t SEND_ALLOCATIONS = 11;
+constexpr size_t SEND_FIXED_BYTES = 1024;
+constexpr size_t SEND_PAYLOAD_COPIES = 1;
+constexpr size_t RECEIVE_ALLOCATIONS = 9;
+constexpr size_t RECEIVE_FIXED_BYTES = 512;
+constexpr size_t RECEIVE_PAYLOAD_COPIES = 2;
+
+struct ExposeKeyString : public transport::ZenohUTransport {
+	using transport::ZenohUTransport::toZenohKeyString;
+};
+
+class AllocationBudgetTest : public testing::Test {
+protected:
+	// Run once per TEST_F.
+	// Used to set up clean environments per test.
+	void SetUp() override {}
+	void TearDown() override {}
+
+	// Run once per execution of the test application.
+	// Used for setup of all tests. Has access to this instance.
+	AllocationBudgetTest() { zenoh::init_log_from_env_or("error"); }
+
+	// Run once per execution of the test application.
+	// Used only for global setup outside of tests.
+	static void SetUpTestSuite() {}
+	static void TearDownTestSuite() {}
+
+	static void report(const std::string& name,
+	                   const test::AllocationCount& per_message) {
+		std::cout << "[ ALLOC    ] " << name << ": "
+		          << per_message.allocations << " allocations, "
+		          << per_message.bytes << " bytes" << std::endl;
+	}
+
+public:
+	~AllocationBudgetTest() override = default;
+};
+
+// Parameter is the payload size
+class PayloadAllocationBudgetTest
+    : public AllocationBudgetTest,
+      public testing::WithParamInterface<size_t> {
+public:
+	~PayloadAllocationBudgetTest() override = default;
+};
+
+TEST_F(AllocationBudgetTest, ToZenohKeyString) {  // NOLINT
+	const auto source = benchmark::makeUUri(TX_ENTITY, TOPIC);
+	const auto sink = benchmark::makeUUri(RX_ENTITY, 0);
+	const std::string authority = "test0";
+
+	const auto before = test::threadAllocations();
+	const auto key = ExposeKeyString::toZenohKeyString(authority, source, sink);
+	const auto used = test::threadAllocations() - before;
+
+	report("toZenohKeyString", used);
+	EXPECT_LE(used.allocations, KEY_ALLOCATIONS);
+	EXPECT_LE(used.bytes, KEY_BYTES);
+}
+
+// Sends from one session to another, so that the receive side runs on the
+// receiving session's threads. Allocations of the sending thread are
+// charged to sends. Allocations of a receiving thread between two
+// consecutive messages are charged to the second one, if both were
+// delivered on that thread.
+TEST_P(PayloadAllocationBudgetTest, SendAndReceive) {  // NOLINT
+	const size_t payload_size = GetParam();
+	const size_t total_messages = WARMUP_MESSAGES + MEASURED_MESSAGES;
+
+	const auto configs = test::makeLinkedConfigs("allocation_budget");
+	auto rx = std::make_shared<transport::ZenohUTransport>(
+	    benchmark::makeUUri(RX_ENTITY, 0), configs.listener);
+	auto tx = std::make_shared<transport::ZenohUTransport>(
+	    benchmark::makeUUri(TX_ENTITY, 0), configs.connector);
+
+	std::mutex mutex;
+	std::condition_variable all_received;
+	size_t received = 0;
+	std::thread::id previous_thread;
+	test::AllocationCount previous;
+	test::AllocationCount receive_used;
+	size_t receive_measured = 0;
+	auto handle = rx->registerListener(
+	    [&](const v1::UMessage&) {
+		    const auto now = test::threadAllocations();
+		    std::lock_guard<std::mutex> lock(mutex);
+		    ++received;
+		    if ((received > WARMUP_MESSAGES) &&
+		        (previous_thread == std::this_thread::get_id())) {
+			    receive_used += now - previous;
+			    ++receive_measured;
+		    }
+		    previous_thread = std::this_thread::get_id();
+		    previous = test::threadAllocations();
+		    if (received == total_messages) {
+			    all_received.notify_one();
+		    }
+	    },
+	    benchmark::makeUUri(TX_ENTITY, TOPIC));
+	ASSERT_TRUE(handle);
+	std::this_thread::sleep_for(CONNECT_DELAY);
+
+	const auto message = benchmark::makePublishMessage(
+	    benchmark::makeUUri(TX_ENTITY, TOPIC), std::string(payload_size, 'x'));
+	for (size_t i = 0; i < WARMUP_MESSAGES; ++i) {
+		ASSERT_EQ(tx->send(message).code(), v1::UCode::OK);
+	}
+	const auto before = test::threadAllocations();
+	for (size_t i = 0; i < MEASURED_MESSAGES; ++i) {
+		ASSERT_EQ(tx->send(message).code(), v1::UCode::OK);
+	}
+	const auto send_used = test::threadAllocations() - before;
+
+	std::unique_lock<std::mutex> lock(mutex);
+	ASSERT_TRUE(all_received.wait_for(lock, DELIVERY_TIMEOUT, [&]() {
+		return received == total_messages;
+	}));
+
+	const test::AllocationCount per_send{
+	    send_used.allocations / MEASURED_MESSAGES,
+	    send_used.bytes / MEASURED_MESSAGES};
+	ASSERT_GT(receive_measured, MEASURED_MESSAGES / 2);
+	const test::AllocationCount per_receive{
+	    receive_used.allocations / receive_measured,
+	    receive_used.bytes / receive_measured};
+	report("send payload=" + std::to_string(payload_size), per_send);
+	report("receive payload=" + std::to_string(payload_size), per_receive);
+
+	EXPECT_LE(per_send.allocations, SEND_ALLOCATIONS);
+	EXPECT_LE(per_send.bytes,
+	          SEND_FIXED_BYTES + (SEND_PAYLOAD_COPIES * payload_size));
+	EXPECT_LE(per_receive.allocations, RECEIVE_ALLOCATIONS);
+	EXPECT_LE(per_receive.bytes,
+	          RECEIVE_FIXED_BYTES + (RECEIVE_PAYLOAD_COPIES * payload_size));
+}
+
+INSTANTIATE_TEST_SUITE_P(PayloadSizes,  // NOLINT
+                         PayloadAllocationBudgetTest,
+                         testing::Values(0, 1024, 64 * 1024));
+
+}  // namespace uprotocol
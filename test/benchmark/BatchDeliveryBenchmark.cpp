@@ -0,0 +1,152 @@
+// SPDX-FileCopyrightText: 2024 Contributors to the Eclipse Foundation
+//
+// See the NOTICE file(s) distributed with this work for additional
+// information regarding copyright ownership.
+//
+// This program and the accompanying materials are made available under the
+// terms of the Apache License Version 2.0 which is available at
+// https://www.apache.org/licenses/LICENSE-2.0
+//
+// SPDX-License-Identifier: Apache-2.0
+
+#include <gtest/gtest.h>
+
+#include <cstring>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "BenchmarkUtils.h"
+#include "up-transport-zenoh-cpp/ZenohUTransport.h"
+
+namespace uprotocol {
+
+constexpr uint32_t TX_ENTITY = 0x10001;
+constexpr uint32_t RX_ENTITY = 0x10002;
+constexpr uint16_t TOPIC = 0x8000;
+constexpr uint16_t BASE_PORT = 17550;
+constexpr size_t NUM_MESSAGES = 100000;
+constexpr auto MAX_DELAY = std::chrono::microseconds(1000);
+constexpr auto CONNECT_DELAY = std::chrono::seconds(1);
+constexpr auto IDLE_TIMEOUT = std::chrono::milliseconds(500);
+
+// Parameter is the batch size, 0 for a plain listener
+class BatchDeliveryBenchmark : public testing::TestWithParam<size_t> {
+protected:
+	// Run once per TEST_P.
+	// Used to set up clean environments per test.
+	void SetUp() override {}
+	void TearDown() override {}
+
+	// Run once per execution of the test application.
+	// Used for setup of all tests. Has access to this instance.
+	BatchDeliveryBenchmark() { zenoh::init_log_from_env_or("error"); }
+
+	// Run once per execution of the test application.
+	// Used only for global setup outside of tests.
+	static void SetUpTestSuite() {}
+	static void TearDownTestSuite() {}
+
+	static uint16_t nextPort() {
+		static uint16_t port = BASE_PORT;
+		return port++;
+	}
+
+public:
+	~BatchDeliveryBenchmark() override = default;
+};
+
+// Each message carries its send time. The receiving side takes a lock for
+// each callback, as an application sharing state with other threads
+// would, and records the latency of every message.
+TEST_P(BatchDeliveryBenchmark, ThroughputAndLatency) {  // NOLINT
+	const size_t batch_size = GetParam();
+	const auto topic = benchmark::makeUUri(TX_ENTITY, TOPIC);
+
+	const auto configs =
+	    benchmark::makeLinkedConfigs("batch_delivery", nextPort());
+	auto rx = std::make_shared<transport::ZenohUTransport>(
+	    benchmark::makeUUri(RX_ENTITY, 0), configs.listener);
+	auto tx = std::make_shared<transport::ZenohUTransport>(
+	    benchmark::makeUUri(TX_ENTITY, 0), configs.connector);
+
+	std::mutex mutex;
+	std::vector<int64_t> latencies_ns;
+	latencies_ns.reserve(NUM_MESSAGES);
+	int64_t last_received_ns = 0;
+	auto record = [&latencies_ns, &last_received_ns](
+	                  const v1::UMessage& message, int64_t now_ns) {
+		int64_t sent_ns = 0;
+		std::memcpy(&sent_ns, message.payload().data(), sizeof(sent_ns));
+		latencies_ns.push_back(now_ns - sent_ns);
+		last_received_ns = now_ns;
+	};
+
+	std::optional<transport::ZenohUTransport::ListenHandle> handle;
+	std::unique_ptr<transport::BatchSubscription> subscription;
+	if (batch_size == 0) {
+		auto result = rx->registerListener(
+		    [&mutex, &record](const v1::UMessage& message) {
+			    const auto now_ns = benchmark::nowNs();
+			    std::lock_guard<std::mutex> lock(mutex);
+			    record(message, now_ns);
+		    },
+		    topic);
+		ASSERT_TRUE(result);
+		handle = std::move(result).value();
+	} else {
+		transport::BatchSubscription::Config config;
+		config.max_batch = batch_size;
+		config.max_delay = MAX_DELAY;
+		auto result = rx->createBatchSubscription(
+		    topic, {}, config,
+		    [&mutex, &record](std::vector<v1::UMessage>& messages) {
+			    const auto now_ns = benchmark::nowNs();
+			    std::lock_guard<std::mutex> lock(mutex);
+			    for (const auto& message : messages) {
+				    record(message, now_ns);
+			    }
+		    });
+		ASSERT_TRUE(result);
+		subscription = std::move(result).value();
+	}
+	std::this_thread::sleep_for(CONNECT_DELAY);
+
+	auto message = benchmark::makePublishMessage(topic, {});
+	const auto start_ns = benchmark::nowNs();
+	for (size_t i = 0; i < NUM_MESSAGES; ++i) {
+		const auto now_ns = benchmark::nowNs();
+		message.mutable_payload()->assign(
+		    reinterpret_cast<const char*>(&now_ns), sizeof(now_ns));
+		EXPECT_EQ(tx->send(message).code(), v1::UCode::OK);
+	}
+
+	// Messages may be dropped under congestion, so wait until they stop
+	// arriving rather than for all of them
+	size_t received = 0;
+	while (true) {
+		std::this_thread::sleep_for(IDLE_TIMEOUT);
+		std::lock_guard<std::mutex> lock(mutex);
+		if (latencies_ns.size() == received) {
+			break;
+		}
+		received = latencies_ns.size();
+	}
+
+	std::lock_guard<std::mutex> lock(mutex);
+	const double received_per_second =
+	    static_cast<double>(received) * 1e9 /
+	    static_cast<double>(last_received_ns - start_ns);
+	std::cout << "[ BENCH    ] batch=" << batch_size << ": "
+	          << received_per_second << " msg/s received, " << received << "/"
+	          << NUM_MESSAGES << " received" << std::endl;
+	benchmark::report("batch=" + std::to_string(batch_size) + " latency",
+	                  benchmark::summarize(latencies_ns));
+	EXPECT_GT(received, 0);
+}
+
+INSTANTIATE_TEST_SUITE_P(BatchSizes,  // NOLINT
+                         BatchDeliveryBenchmark,
+                         testing::Values(0, 1, 16, 64, 256));
+
+}  // namespace uprotocol
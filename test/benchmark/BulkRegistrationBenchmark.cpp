@@ -0,0 +1,97 @@
+// SPDX-FileCopyrightText: 2024 Contributors to the Eclipse Foundation
+//
+// See the NOTICE file(s) distributed with this work for additional
+// information regarding copyright ownership.
+//
+// This program and the accompanying materials are made available under the
+// terms of the Apache License Version 2.0 which is available at
+// https://www.apache.org/licenses/LICENSE-2.0
+//
+// SPDX-License-Identifier: Apache-2.0
+
+#include <gtest/gtest.h>
+
+#include <vector>
+
+#include "BenchmarkUtils.h"
+#include "up-transport-zenoh-cpp/ZenohUTransport.h"
+
+namespace uprotocol {
+
+constexpr std::string_view ZENOH_CONFIG_FILE = BUILD_REALPATH_ZENOH_CONF;
+
+constexpr uint32_t ENTITY_ID = 0x10001;
+constexpr size_t NUM_TOPICS = 1000;
+constexpr uint16_t FIRST_TOPIC = 0x8000;
+
+class BulkRegistrationBenchmark : public testing::Test {
+protected:
+	// Run once per TEST_F.
+	// Used to set up clean environments per test.
+	void SetUp() override {}
+	void TearDown() override {}
+
+	// Run once per execution of the test application.
+	// Used for setup of all tests. Has access to this instance.
+	BulkRegistrationBenchmark() { zenoh::init_log_from_env_or("error"); }
+
+	// Run once per execution of the test application.
+	// Used only for global setup outside of tests.
+	static void SetUpTestSuite() {}
+	static void TearDownTestSuite() {}
+
+public:
+	~BulkRegistrationBenchmark() override = default;
+};
+
+std::shared_ptr<transport::ZenohUTransport> getTransport() {
+	return std::make_shared<transport::ZenohUTransport>(
+	    benchmark::makeUUri(ENTITY_ID, 0), ZENOH_CONFIG_FILE);
+}
+
+v1::UUri topicFor(size_t index) {
+	return benchmark::makeUUri(ENTITY_ID,
+	                           static_cast<uint16_t>(FIRST_TOPIC + index));
+}
+
+TEST_F(BulkRegistrationBenchmark, StartupWith1kTopics) {  // NOLINT
+	std::vector<transport::UTransport::ListenHandle> serial_handles;
+	double serial_ms = 0;
+	{
+		auto transport = getTransport();
+		const int64_t start = benchmark::nowNs();
+		for (size_t index = 0; index < NUM_TOPICS; ++index) {
+			auto result = transport->registerListener(
+			    [](const v1::UMessage&) {}, topicFor(index));
+			ASSERT_TRUE(result);
+			serial_handles.push_back(std::move(result.value()));
+		}
+		serial_ms = static_cast<double>(benchmark::nowNs() - start) / 1e6;
+		serial_handles.clear();
+	}
+
+	double bulk_ms = 0;
+	{
+		auto transport = getTransport();
+		std::vector<transport::ZenohUTransport::ListenerRegistration>
+		    registrations;
+		for (size_t index = 0; index < NUM_TOPICS; ++index) {
+			registrations.push_back(
+			    {[](const v1::UMessage&) {}, topicFor(index), {}});
+		}
+		const int64_t start = benchmark::nowNs();
+		auto results = transport->registerListeners(std::move(registrations));
+		bulk_ms = static_cast<double>(benchmark::nowNs() - start) / 1e6;
+
+		ASSERT_EQ(results.size(), NUM_TOPICS);
+		for (const auto& result : results) {
+			EXPECT_TRUE(result);
+		}
+	}
+
+	std::cout << "[ BENCH    ] " << NUM_TOPICS
+	          << " topics: serial registerListener=" << serial_ms << "ms"
+	          << " registerListeners=" << bulk_ms << "ms" << std::endl;
+}
+
+}  // namespace uprotocol
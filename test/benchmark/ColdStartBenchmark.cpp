@@ -0,0 +1,112 @@
+// SPDX-FileCopyrightText: 2024 Contributors to the Eclipse Foundation
+//
+// See the NOTICE file(s) distributed with this work for additional
+// information regarding copyright ownership.
+//
+// This program and the accompanying materials are made available under the
+// terms of the Apache License Version 2.0 which is available at
+// https://www.apache.org/licenses/LICENSE-2.0
+//
+// SPDX-License-Identifier: Apache-2.0
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+#include "BenchmarkUtils.h"
+#include "up-transport-zenoh-cpp/ZenohUTransport.h"
+
+namespace uprotocol {
+
+constexpr uint32_t TX_ENTITY = 0x10001;
+constexpr uint32_t RX_ENTITY = 0x10002;
+constexpr uint16_t TOPIC = 0x8000;
+constexpr uint16_t BASE_PORT = 17490;
+constexpr size_t NUM_STARTS = 5;
+constexpr auto RESEND_INTERVAL = std::chrono::milliseconds(1);
+constexpr auto DELIVERY_TIMEOUT = std::chrono::seconds(10);
+
+// Parameter is whether the starting transport opens its session
+// asynchronously
+class ColdStartBenchmark : public testing::TestWithParam<bool> {
+protected:
+	// Run once per TEST_P.
+	// Used to set up clean environments per test.
+	void SetUp() override {}
+	void TearDown() override {}
+
+	// Run once per execution of the test application.
+	// Used for setup of all tests. Has access to this instance.
+	ColdStartBenchmark() { zenoh::init_log_from_env_or("error"); }
+
+	// Run once per execution of the test application.
+	// Used only for global setup outside of tests.
+	static void SetUpTestSuite() {}
+	static void TearDownTestSuite() {}
+
+	static uint16_t nextPort() {
+		static uint16_t port = BASE_PORT;
+		return port++;
+	}
+
+public:
+	~ColdStartBenchmark() override = default;
+};
+
+// A receiver is already running when the sender starts. Measures the time
+// from the start of the sender's constructor until the receiver gets the
+// first message, which the sender keeps sending until it gets through.
+TEST_P(ColdStartBenchmark, TimeToFirstDelivery) {  // NOLINT
+	const bool open_async = GetParam();
+	const auto topic = benchmark::makeUUri(TX_ENTITY, TOPIC);
+	const auto message = benchmark::makePublishMessage(topic, "cold start");
+
+	std::vector<int64_t> constructor_ns;
+	std::vector<int64_t> first_delivery_ns;
+	for (size_t start = 0; start < NUM_STARTS; ++start) {
+		const auto configs =
+		    benchmark::makeLinkedConfigs("cold_start", nextPort());
+		auto rx = std::make_shared<transport::ZenohUTransport>(
+		    benchmark::makeUUri(RX_ENTITY, 0), configs.listener);
+		std::atomic<bool> received = false;
+		auto handle = rx->registerListener(
+		    [&received](const v1::UMessage&) { received = true; }, topic);
+		ASSERT_TRUE(handle);
+
+		transport::ZenohUTransportOptions options;
+		options.open_session_async = open_async;
+		const auto begin = benchmark::nowNs();
+		auto tx = std::make_shared<transport::ZenohUTransport>(
+		    benchmark::makeUUri(TX_ENTITY, 0), configs.connector, options);
+		constructor_ns.push_back(benchmark::nowNs() - begin);
+
+		const auto deadline =
+		    std::chrono::steady_clock::now() + DELIVERY_TIMEOUT;
+		while (!received && (std::chrono::steady_clock::now() < deadline)) {
+			EXPECT_EQ(tx->send(message).code(), v1::UCode::OK);
+			std::this_thread::sleep_for(RESEND_INTERVAL);
+		}
+		ASSERT_TRUE(received);
+		first_delivery_ns.push_back(benchmark::nowNs() - begin);
+
+		const auto timings = tx->getStartupTimings();
+		std::cout << "[ BENCH    ] async=" << open_async << " load_config="
+		          << timings.load_config.count() / 1000
+		          << "us open_session=" << timings.open_session.count() / 1000
+		          << "us until_open=" << timings.until_open.count() / 1000
+		          << "us" << std::endl;
+	}
+
+	const auto prefix = std::string(open_async ? "async" : "sync");
+	benchmark::report(prefix + " constructor",
+	                  benchmark::summarize(constructor_ns));
+	benchmark::report(prefix + " first delivery",
+	                  benchmark::summarize(first_delivery_ns));
+}
+
+INSTANTIATE_TEST_SUITE_P(OpenMode,  // NOLINT
+                         ColdStartBenchmark, testing::Bool());
+
+}  // namespace uprotocol
@@ -0,0 +1,136 @@
+// SPDX-FileCopyrightText: 2024 Contributors to the Eclipse Foundation
+//
+// See the NOTICE file(s) distributed with this work for additional
+// information regarding copyright ownership.
+//
+// This program and the accompanying materials are made available under the
+// terms of the Apache License Version 2.0 which is available at
+// https://www.apache.org/licenses/LICENSE-2.0
+//
+// SPDX-License-Identifier: Apache-2.0
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <thread>
+#include <tuple>
+#include <vector>
+
+#include "AllocationCounter.h"
+#include "BenchmarkUtils.h"
+#include "up-transport-zenoh-cpp/ZenohUTransport.h"
+
+namespace uprotocol {
+
+constexpr uint32_t TX_ENTITY = 0x10001;
+constexpr uint32_t FIRST_SINK_ENTITY = 0x20001;
+constexpr uint16_t TOPIC = 0x8000;
+constexpr uint16_t BASE_PORT = 17510;
+constexpr size_t NUM_FAN_OUTS = 200;
+constexpr auto CONNECT_DELAY = std::chrono::seconds(1);
+constexpr auto DRAIN_DELAY = std::chrono::milliseconds(500);
+
+// Parameters are the number of sinks and the payload size
+class FanOutBenchmark
+    : public testing::TestWithParam<std::tuple<size_t, size_t>> {
+protected:
+	// Run once per TEST_P.
+	// Used to set up clean environments per test.
+	void SetUp() override {}
+	void TearDown() override {}
+
+	// Run once per execution of the test application.
+	// Used for setup of all tests. Has access to this instance.
+	FanOutBenchmark() { zenoh::init_log_from_env_or("error"); }
+
+	// Run once per execution of the test application.
+	// Used only for global setup outside of tests.
+	static void SetUpTestSuite() {}
+	static void TearDownTestSuite() {}
+
+	static uint16_t nextPort() {
+		static uint16_t port = BASE_PORT;
+		return port++;
+	}
+
+public:
+	~FanOutBenchmark() override = default;
+};
+
+// Sends the same notification to every sink, first with one send() per
+// sink and then with a single sendToSinks(), and compares the time and
+// the heap allocations of the sending thread per fan-out.
+TEST_P(FanOutBenchmark, SendsVersusSendToSinks) {  // NOLINT
+	const auto [num_sinks, payload_size] = GetParam();
+
+	const auto configs = benchmark::makeLinkedConfigs("fan_out", nextPort());
+	auto rx = std::make_shared<transport::ZenohUTransport>(
+	    benchmark::makeUUri(FIRST_SINK_ENTITY, 0), configs.listener);
+	auto tx = std::make_shared<transport::ZenohUTransport>(
+	    benchmark::makeUUri(TX_ENTITY, 0), configs.connector);
+
+	const auto source = benchmark::makeUUri(TX_ENTITY, TOPIC);
+	std::vector<v1::UUri> sinks;
+	std::atomic<size_t> received = 0;
+	std::vector<transport::ZenohUTransport::ListenHandle> handles;
+	for (size_t sink = 0; sink < num_sinks; ++sink) {
+		sinks.push_back(benchmark::makeUUri(
+		    static_cast<uint32_t>(FIRST_SINK_ENTITY + sink), 0));
+		auto handle = rx->registerListener(
+		    [&received](const v1::UMessage&) { ++received; }, source,
+		    sinks.back());
+		ASSERT_TRUE(handle);
+		handles.push_back(std::move(handle).value());
+	}
+	std::this_thread::sleep_for(CONNECT_DELAY);
+
+	auto notification = benchmark::makePublishMessage(
+	    source, std::string(payload_size, 'x'));
+	notification.mutable_attributes()->set_type(
+	    v1::UMessageType::UMESSAGE_TYPE_NOTIFICATION);
+
+	auto report = [num_sinks = num_sinks, payload_size = payload_size](
+	                  const char* name, int64_t elapsed_ns,
+	                  const test::AllocationCount& allocated) {
+		std::cout << "[ BENCH    ] " << name << " sinks=" << num_sinks
+		          << " payload=" << payload_size << ": "
+		          << (elapsed_ns / static_cast<int64_t>(NUM_FAN_OUTS))
+		          << " ns/fan-out, "
+		          << (allocated.allocations / NUM_FAN_OUTS)
+		          << " allocations/fan-out, "
+		          << (allocated.bytes / NUM_FAN_OUTS) << " bytes/fan-out"
+		          << std::endl;
+	};
+
+	auto per_sink = notification;
+	auto start_allocations = test::threadAllocations();
+	auto start = benchmark::nowNs();
+	for (size_t fan_out = 0; fan_out < NUM_FAN_OUTS; ++fan_out) {
+		for (const auto& sink : sinks) {
+			*per_sink.mutable_attributes()->mutable_sink() = sink;
+			EXPECT_EQ(tx->send(per_sink).code(), v1::UCode::OK);
+		}
+	}
+	report("send", benchmark::nowNs() - start,
+	       test::threadAllocations() - start_allocations);
+
+	start_allocations = test::threadAllocations();
+	start = benchmark::nowNs();
+	for (size_t fan_out = 0; fan_out < NUM_FAN_OUTS; ++fan_out) {
+		for (const auto& status : tx->sendToSinks(notification, sinks)) {
+			EXPECT_EQ(status.code(), v1::UCode::OK);
+		}
+	}
+	report("sendToSinks", benchmark::nowNs() - start,
+	       test::threadAllocations() - start_allocations);
+
+	std::this_thread::sleep_for(DRAIN_DELAY);
+	EXPECT_GT(received, 0);
+}
+
+INSTANTIATE_TEST_SUITE_P(SinksAndPayloads,  // NOLINT
+                         FanOutBenchmark,
+                         testing::Combine(testing::Values(8, 32, 128),
+                                          testing::Values(64, 4096)));
+
+}  // namespace uprotocol
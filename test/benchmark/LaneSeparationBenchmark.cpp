@@ -0,0 +1,144 @@
+// SPDX-FileCopyrightText: 2024 Contributors to the Eclipse Foundation
+//
+// See the NOTICE file(s) distributed with this work for additional
+// information regarding copyright ownership.
+//
+// This program and the accompanying materials are made available under the
+// terms of the Apache License Version 2.0 which is available at
+// https://www.apache.org/licenses/LICENSE-2.0
+//
+// SPDX-License-Identifier: Apache-2.0
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <cstring>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <vector>
+
+#include "BenchmarkUtils.h"
+#include "up-transport-zenoh-cpp/ZenohUTransport.h"
+
+namespace uprotocol {
+
+constexpr uint32_t TX_ENTITY = 0x10001;
+constexpr uint32_t RX_ENTITY = 0x10002;
+constexpr uint16_t SMALL_TOPIC = 0x8000;
+constexpr uint16_t LARGE_TOPIC = 0x8001;
+constexpr uint16_t BASE_PORT = 17570;
+constexpr size_t LARGE_PAYLOAD_SIZE = size_t{4} * 1024 * 1024;
+constexpr size_t NUM_SMALL_MESSAGES = 2000;
+constexpr auto SMALL_INTERVAL = std::chrono::microseconds(1000);
+constexpr auto CONNECT_DELAY = std::chrono::seconds(1);
+constexpr auto DRAIN_DELAY = std::chrono::milliseconds(500);
+
+// Parameter is whether the large payload lane is enabled
+class LaneSeparationBenchmark : public testing::TestWithParam<bool> {
+protected:
+	// Run once per TEST_P.
+	// Used to set up clean environments per test.
+	void SetUp() override {}
+	void TearDown() override {}
+
+	// Run once per execution of the test application.
+	// Used for setup of all tests. Has access to this instance.
+	LaneSeparationBenchmark() { zenoh::init_log_from_env_or("error"); }
+
+	// Run once per execution of the test application.
+	// Used only for global setup outside of tests.
+	static void SetUpTestSuite() {}
+	static void TearDownTestSuite() {}
+
+	static uint16_t nextPort() {
+		static uint16_t port = BASE_PORT;
+		return port++;
+	}
+
+	static std::string laneName(bool lane) {
+		return lane ? "lower_priority" : "shared";
+	}
+
+public:
+	~LaneSeparationBenchmark() override = default;
+};
+
+// A background thread keeps sending large payloads on one topic while
+// small messages of the same UPriority are sent at a fixed rate on another.
+// Measures the latency of the small messages, each carrying its send time.
+TEST_P(LaneSeparationBenchmark, SmallMessageLatency) {  // NOLINT
+	const auto lane = GetParam();
+	const auto small_topic = benchmark::makeUUri(TX_ENTITY, SMALL_TOPIC);
+	const auto large_topic = benchmark::makeUUri(TX_ENTITY, LARGE_TOPIC);
+
+	const auto configs =
+	    benchmark::makeLinkedConfigs("lane_separation", nextPort());
+	auto rx = std::make_shared<transport::ZenohUTransport>(
+	    benchmark::makeUUri(RX_ENTITY, 0), configs.listener);
+	transport::ZenohUTransportOptions tx_options;
+	if (lane) {
+		tx_options.large_payload_lane = transport::LargePayloadLane{};
+	}
+	auto tx = std::make_shared<transport::ZenohUTransport>(
+	    benchmark::makeUUri(TX_ENTITY, 0), configs.connector, tx_options);
+
+	std::mutex mutex;
+	std::vector<int64_t> latencies_ns;
+	latencies_ns.reserve(NUM_SMALL_MESSAGES);
+	auto small_handle = rx->registerListener(
+	    [&mutex, &latencies_ns](const v1::UMessage& message) {
+		    const auto now_ns = benchmark::nowNs();
+		    int64_t sent_ns = 0;
+		    std::memcpy(&sent_ns, message.payload().data(), sizeof(sent_ns));
+		    std::lock_guard<std::mutex> lock(mutex);
+		    latencies_ns.push_back(now_ns - sent_ns);
+	    },
+	    small_topic);
+	std::atomic<size_t> large_received = 0;
+	auto large_handle = rx->registerListener(
+	    [&large_received](const v1::UMessage&) { ++large_received; },
+	    large_topic);
+	ASSERT_TRUE(small_handle);
+	ASSERT_TRUE(large_handle);
+	std::this_thread::sleep_for(CONNECT_DELAY);
+
+	std::atomic<bool> stop = false;
+	size_t large_sent = 0;
+	std::thread large_sender([&tx, &stop, &large_sent, &large_topic]() {
+		const auto large = benchmark::makePublishMessage(
+		    large_topic, std::string(LARGE_PAYLOAD_SIZE, 'x'));
+		while (!stop) {
+			EXPECT_EQ(tx->send(large).code(), v1::UCode::OK);
+			++large_sent;
+		}
+	});
+
+	auto small = benchmark::makePublishMessage(small_topic, {});
+	auto next_send = std::chrono::steady_clock::now();
+	for (size_t i = 0; i < NUM_SMALL_MESSAGES; ++i) {
+		std::this_thread::sleep_until(next_send);
+		next_send += SMALL_INTERVAL;
+		const auto now_ns = benchmark::nowNs();
+		small.mutable_payload()->assign(
+		    reinterpret_cast<const char*>(&now_ns), sizeof(now_ns));
+		EXPECT_EQ(tx->send(small).code(), v1::UCode::OK);
+	}
+	stop = true;
+	large_sender.join();
+	std::this_thread::sleep_for(DRAIN_DELAY);
+
+	std::lock_guard<std::mutex> lock(mutex);
+	std::cout << "[ BENCH    ] lane=" << laneName(lane) << ": "
+	          << large_received << "/" << large_sent
+	          << " large payloads received" << std::endl;
+	benchmark::report("lane=" + laneName(lane) + " small message latency",
+	                  benchmark::summarize(latencies_ns));
+	EXPECT_GT(latencies_ns.size(), 0);
+}
+
+INSTANTIATE_TEST_SUITE_P(Lanes,  // NOLINT
+                         LaneSeparationBenchmark,
+                         testing::Bool());
+
+}  // namespace uprotocol
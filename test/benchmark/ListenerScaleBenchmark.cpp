@@ -0,0 +1,153 @@
+// SPDX-FileCopyrightText: 2024 Contributors to the Eclipse Foundation
+//
+// See the NOTICE file(s) distributed with this work for additional
+// information regarding copyright ownership.
+//
+// This program and the accompanying materials are made available under the
+// terms of the Apache License Version 2.0 which is available at
+// https://www.apache.org/licenses/LICENSE-2.0
+//
+// SPDX-License-Identifier: Apache-2.0
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+#include "BenchmarkUtils.h"
+#include "up-transport-zenoh-cpp/ZenohUTransport.h"
+
+namespace uprotocol {
+
+constexpr std::string_view ZENOH_CONFIG_FILE = BUILD_REALPATH_ZENOH_CONF;
+
+constexpr uint32_t ENTITY_ID = 0x10001;
+constexpr size_t NUM_THREADS = 4;
+constexpr size_t DISPATCH_SAMPLES = 1000;
+
+// Regression thresholds. These are deliberately loose so that they hold on
+// shared CI machines, while still catching per-listener costs that grow
+// with the number of registered listeners.
+constexpr double MAX_REGISTRATION_P99_US = 5000;
+constexpr double MAX_RSS_PER_LISTENER_BYTES = 32 * 1024;
+constexpr double MAX_DISPATCH_US = 500;
+
+class ListenerScaleBenchmark : public testing::TestWithParam<size_t> {
+protected:
+	// Run once per TEST_P.
+	// Used to set up clean environments per test.
+	void SetUp() override {}
+	void TearDown() override {}
+
+	// Run once per execution of the test application.
+	// Used for setup of all tests. Has access to this instance.
+	ListenerScaleBenchmark() { zenoh::init_log_from_env_or("error"); }
+
+	// Run once per execution of the test application.
+	// Used only for global setup outside of tests.
+	static void SetUpTestSuite() {}
+	static void TearDownTestSuite() {}
+
+public:
+	~ListenerScaleBenchmark() override = default;
+};
+
+// Spreads listeners over distinct topics, 0x4000 per source entity.
+v1::UUri topicFor(size_t index) {
+	constexpr size_t TOPICS_PER_ENTITY = 0x4000;
+	constexpr uint16_t FIRST_TOPIC = 0x8000;
+	return benchmark::makeUUri(
+	    ENTITY_ID + static_cast<uint32_t>(index / TOPICS_PER_ENTITY),
+	    static_cast<uint16_t>(FIRST_TOPIC + (index % TOPICS_PER_ENTITY)));
+}
+
+// Runs fn(index) for every index in [0, count) over NUM_THREADS threads.
+template <typename Fn>
+void parallelFor(size_t count, Fn&& fn) {
+	std::vector<std::thread> threads;
+	for (size_t t = 0; t < NUM_THREADS; ++t) {
+		threads.emplace_back([&fn, count, t]() {
+			for (size_t index = t; index < count; index += NUM_THREADS) {
+				fn(index);
+			}
+		});
+	}
+	for (auto& thread : threads) {
+		thread.join();
+	}
+}
+
+TEST_P(ListenerScaleBenchmark, RegisterDispatchUnregister) {  // NOLINT
+	const size_t num_listeners = GetParam();
+	const std::string name =
+	    "listeners=" + std::to_string(num_listeners) + ": ";
+
+	auto transport = std::make_shared<transport::ZenohUTransport>(
+	    benchmark::makeUUri(ENTITY_ID, 0), ZENOH_CONFIG_FILE);
+
+	std::atomic<size_t> received = 0;
+	std::atomic<size_t> failures = 0;
+	std::vector<transport::UTransport::ListenHandle> handles(num_listeners);
+	std::vector<int64_t> latencies(num_listeners);
+
+	// Registration
+	const auto rss_before =
+	    static_cast<double>(benchmark::currentRssBytes());
+	const int64_t register_start = benchmark::nowNs();
+	parallelFor(num_listeners, [&](size_t index) {
+		const int64_t start = benchmark::nowNs();
+		auto result = transport->registerListener(
+		    [&received](const v1::UMessage&) { ++received; },
+		    topicFor(index));
+		latencies[index] = benchmark::nowNs() - start;
+		if (result) {
+			handles[index] = std::move(result.value());
+		} else {
+			++failures;
+		}
+	});
+	const double register_total_ms =
+	    static_cast<double>(benchmark::nowNs() - register_start) / 1e6;
+	const double rss_per_listener =
+	    (static_cast<double>(benchmark::currentRssBytes()) - rss_before) /
+	    static_cast<double>(num_listeners);
+	const auto registration = benchmark::summarize(latencies);
+
+	// Dispatch to one listener among all the registered ones
+	const auto message =
+	    benchmark::makePublishMessage(topicFor(num_listeners / 2), "payload");
+	const int64_t dispatch_start = benchmark::nowNs();
+	for (size_t i = 0; i < DISPATCH_SAMPLES; ++i) {
+		EXPECT_EQ(transport->send(message).code(), v1::UCode::OK);
+	}
+	const double dispatch_us =
+	    static_cast<double>(benchmark::nowNs() - dispatch_start) / 1e3 /
+	    static_cast<double>(DISPATCH_SAMPLES);
+
+	// Unregistration
+	const int64_t unregister_start = benchmark::nowNs();
+	parallelFor(num_listeners, [&handles](size_t index) {
+		handles[index].reset();
+	});
+	const double unregister_total_ms =
+	    static_cast<double>(benchmark::nowNs() - unregister_start) / 1e6;
+
+	benchmark::report(name + "registration latency", registration);
+	std::cout << "[ BENCH    ] " << name
+	          << "register total=" << register_total_ms << "ms"
+	          << " unregister total=" << unregister_total_ms << "ms"
+	          << " rss/listener=" << rss_per_listener << "B"
+	          << " dispatch/sample=" << dispatch_us << "us" << std::endl;
+
+	EXPECT_EQ(failures, 0);
+	EXPECT_EQ(received, DISPATCH_SAMPLES);
+	EXPECT_LE(registration.p99_us, MAX_REGISTRATION_P99_US);
+	EXPECT_LE(rss_per_listener, MAX_RSS_PER_LISTENER_BYTES);
+	EXPECT_LE(dispatch_us, MAX_DISPATCH_US);
+}
+
+INSTANTIATE_TEST_SUITE_P(Scale, ListenerScaleBenchmark,  // NOLINT
+                         testing::Values(1000, 10000, 100000));
+
+}  // namespace uprotocol
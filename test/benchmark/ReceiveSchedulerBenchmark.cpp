@@ -0,0 +1,145 @@
+// SPDX-FileCopyrightText: 2024 Contributors to the Eclipse Foundation
+//
+// See the NOTICE file(s) distributed with this work for additional
+// information regarding copyright ownership.
+//
+// This program and the accompanying materials are made available under the
+// terms of the Apache License Version 2.0 which is available at
+// https://www.apache.org/licenses/LICENSE-2.0
+//
+// SPDX-License-Identifier: Apache-2.0
+
+#include <gtest/gtest.h>
+#include <up-cpp/communication/Publisher.h>
+#include <up-cpp/communication/Subscriber.h>
+
+#include <atomic>
+#include <mutex>
+#include <thread>
+#include <tuple>
+
+#include "BenchmarkUtils.h"
+#include "up-transport-zenoh-cpp/ZenohUTransport.h"
+
+namespace uprotocol {
+
+constexpr int BULK_TOPIC = 0x8000;
+constexpr int CONTROL_TOPIC = 0x8001;
+
+constexpr size_t CONTROL_MESSAGES = 200;
+constexpr auto CONTROL_PERIOD = std::chrono::milliseconds(2);
+// Processing time of each bulk message, enough for the bulk listener to
+// fall behind a publisher sending as fast as it can.
+constexpr auto BULK_WORK = std::chrono::microseconds(200);
+constexpr auto CONNECT_DELAY = std::chrono::seconds(1);
+constexpr auto DRAIN_DELAY = std::chrono::milliseconds(500);
+
+class ReceiveSchedulerBenchmark : public testing::Test {
+protected:
+	// Run once per TEST_F.
+	// Used to set up clean environments per test.
+	void SetUp() override {}
+	void TearDown() override {}
+
+	// Run once per execution of the test application.
+	// Used for setup of all tests. Has access to this instance.
+	ReceiveSchedulerBenchmark() { zenoh::init_log_from_env_or("error"); }
+
+	// Run once per execution of the test application.
+	// Used only for global setup outside of tests.
+	static void SetUpTestSuite() {}
+	static void TearDownTestSuite() {}
+
+public:
+	~ReceiveSchedulerBenchmark() override = default;
+};
+
+// Measures the publish-to-listener latency of CS6 messages while a CS0
+// topic on the same receiving session is saturated.
+benchmark::LatencySummary measureControlLatency(
+    const transport::ZenohUTransportOptions& rx_options, uint16_t port) {
+	constexpr uint32_t TX_ENTITY = 0x10001;
+	constexpr uint32_t RX_ENTITY = 0x10002;
+
+	const auto configs = benchmark::makeLinkedConfigs("rx_scheduler", port);
+	auto rx = std::make_shared<transport::ZenohUTransport>(
+	    benchmark::makeUUri(RX_ENTITY, 0), configs.listener, rx_options);
+	auto tx = std::make_shared<transport::ZenohUTransport>(
+	    benchmark::makeUUri(TX_ENTITY, 0), configs.connector);
+
+	std::mutex latencies_mtx;
+	std::vector<int64_t> latencies;
+
+	auto bulk_sub = communication::Subscriber::subscribe(
+	    rx, benchmark::makeUUri(TX_ENTITY, BULK_TOPIC),
+	    [](const v1::UMessage&) {
+		    const auto until = std::chrono::steady_clock::now() + BULK_WORK;
+		    while (std::chrono::steady_clock::now() < until) {
+		    }
+	    });
+	auto control_sub = communication::Subscriber::subscribe(
+	    rx, benchmark::makeUUri(TX_ENTITY, CONTROL_TOPIC),
+	    [&latencies_mtx, &latencies](const v1::UMessage& message) {
+		    const auto sent = std::stoll(message.payload());
+		    std::lock_guard lock(latencies_mtx);
+		    latencies.push_back(benchmark::nowNs() - sent);
+	    });
+	EXPECT_TRUE(bulk_sub);
+	EXPECT_TRUE(control_sub);
+	std::this_thread::sleep_for(CONNECT_DELAY);
+
+	communication::Publisher bulk(
+	    tx, benchmark::makeUUri(TX_ENTITY, BULK_TOPIC),
+	    v1::UPayloadFormat::UPAYLOAD_FORMAT_TEXT, v1::UPriority::UPRIORITY_CS0);
+	communication::Publisher control(
+	    tx, benchmark::makeUUri(TX_ENTITY, CONTROL_TOPIC),
+	    v1::UPayloadFormat::UPAYLOAD_FORMAT_TEXT, v1::UPriority::UPRIORITY_CS6);
+
+	std::atomic<bool> flooding = true;
+	std::thread flood([&bulk, &flooding]() {
+		const std::string payload(64, 'x');
+		while (flooding) {
+			std::ignore = bulk.publish(
+			    {payload, v1::UPayloadFormat::UPAYLOAD_FORMAT_TEXT});
+		}
+	});
+
+	for (size_t i = 0; i < CONTROL_MESSAGES; ++i) {
+		auto result =
+		    control.publish({std::to_string(benchmark::nowNs()),
+		                     v1::UPayloadFormat::UPAYLOAD_FORMAT_TEXT});
+		EXPECT_EQ(result.code(), v1::UCode::OK);
+		std::this_thread::sleep_for(CONTROL_PERIOD);
+	}
+
+	flooding = false;
+	flood.join();
+	std::this_thread::sleep_for(DRAIN_DELAY);
+
+	std::lock_guard lock(latencies_mtx);
+	return benchmark::summarize(latencies);
+}
+
+TEST_F(ReceiveSchedulerBenchmark, ControlLatencyUnderBulkLoad) {  // NOLINT
+	const auto inline_dispatch =
+	    measureControlLatency(transport::ZenohUTransportOptions{}, 17461);
+	benchmark::report("CS6 latency, inline dispatch", inline_dispatch);
+
+	transport::ZenohUTransportOptions strict;
+	strict.receive_scheduler.emplace();
+	const auto strict_dispatch = measureControlLatency(strict, 17462);
+	benchmark::report("CS6 latency, strict priority", strict_dispatch);
+
+	transport::ZenohUTransportOptions dedicated;
+	dedicated.receive_scheduler.emplace();
+	dedicated.receive_scheduler->dedicated_high_priority_lane = true;
+	dedicated.receive_scheduler->high_priority_cpu = 0;
+	const auto dedicated_dispatch = measureControlLatency(dedicated, 17463);
+	benchmark::report("CS6 latency, dedicated lane", dedicated_dispatch);
+
+	EXPECT_GT(inline_dispatch.count, 0);
+	EXPECT_GT(strict_dispatch.count, 0);
+	EXPECT_GT(dedicated_dispatch.count, 0);
+}
+
+}  // namespace uprotocol
@@ -0,0 +1,124 @@
+// SPDX-FileCopyrightText: 2024 Contributors to the Eclipse Foundation
+//
+// See the NOTICE file(s) distributed with this work for additional
+// information regarding copyright ownership.
+//
+// This program and the accompanying materials are made available under the
+// terms of the Apache License Version 2.0 which is available at
+// https://www.apache.org/licenses/LICENSE-2.0
+//
+// SPDX-License-Identifier: Apache-2.0
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <thread>
+#include <tuple>
+#include <vector>
+
+#include "BenchmarkUtils.h"
+#include "up-transport-zenoh-cpp/ZenohUTransport.h"
+
+namespace uprotocol {
+
+constexpr uint32_t TX_ENTITY = 0x10001;
+constexpr uint32_t RX_ENTITY = 0x10002;
+constexpr uint16_t BASE_PORT = 17470;
+constexpr size_t MESSAGES_PER_THREAD = 20000;
+constexpr size_t FIRST_TOPIC = 0x8000;
+constexpr size_t TOPICS_PER_THREAD = 16;
+constexpr size_t PAYLOAD_SIZE = 256;
+constexpr auto CONNECT_DELAY = std::chrono::seconds(1);
+constexpr auto DRAIN_DELAY = std::chrono::milliseconds(500);
+
+// Parameters are the number of send sessions and of sender threads
+class SendStripingBenchmark
+    : public testing::TestWithParam<std::tuple<size_t, size_t>> {
+protected:
+	// Run once per TEST_P.
+	// Used to set up clean environments per test.
+	void SetUp() override {}
+	void TearDown() override {}
+
+	// Run once per execution of the test application.
+	// Used for setup of all tests. Has access to this instance.
+	SendStripingBenchmark() { zenoh::init_log_from_env_or("error"); }
+
+	// Run once per execution of the test application.
+	// Used only for global setup outside of tests.
+	static void SetUpTestSuite() {}
+	static void TearDownTestSuite() {}
+
+	static uint16_t nextPort() {
+		static uint16_t port = BASE_PORT;
+		return port++;
+	}
+
+public:
+	~SendStripingBenchmark() override = default;
+};
+
+TEST_P(SendStripingBenchmark, Throughput) {  // NOLINT
+	const auto [num_sessions, num_threads] = GetParam();
+
+	const auto configs =
+	    benchmark::makeLinkedConfigs("send_striping", nextPort());
+	auto rx = std::make_shared<transport::ZenohUTransport>(
+	    benchmark::makeUUri(RX_ENTITY, 0), configs.listener);
+
+	transport::ZenohUTransportOptions tx_options;
+	tx_options.send_sessions = num_sessions;
+	auto tx = std::make_shared<transport::ZenohUTransport>(
+	    benchmark::makeUUri(TX_ENTITY, 0), configs.connector, tx_options);
+
+	std::atomic<size_t> received = 0;
+	auto handle = rx->registerListener(
+	    [&received](const v1::UMessage&) { ++received; },
+	    benchmark::makeUUri(TX_ENTITY, 0xFFFF));
+	ASSERT_TRUE(handle);
+	std::this_thread::sleep_for(CONNECT_DELAY);
+
+	// Each thread sends on its own topics
+	std::vector<std::vector<v1::UMessage>> messages(num_threads);
+	for (size_t thread = 0; thread < num_threads; ++thread) {
+		for (size_t topic = 0; topic < TOPICS_PER_THREAD; ++topic) {
+			const auto resource_id = static_cast<uint16_t>(
+			    FIRST_TOPIC + (thread * TOPICS_PER_THREAD) + topic);
+			messages[thread].push_back(benchmark::makePublishMessage(
+			    benchmark::makeUUri(TX_ENTITY, resource_id),
+			    std::string(PAYLOAD_SIZE, 'x')));
+		}
+	}
+
+	const auto start = benchmark::nowNs();
+	std::vector<std::thread> senders;
+	for (size_t thread = 0; thread < num_threads; ++thread) {
+		senders.emplace_back([&tx, &to_send = messages[thread]]() {
+			for (size_t i = 0; i < MESSAGES_PER_THREAD; ++i) {
+				EXPECT_EQ(tx->send(to_send[i % to_send.size()]).code(),
+				          v1::UCode::OK);
+			}
+		});
+	}
+	for (auto& sender : senders) {
+		sender.join();
+	}
+	const auto elapsed_ns = benchmark::nowNs() - start;
+	std::this_thread::sleep_for(DRAIN_DELAY);
+
+	const size_t sent = num_threads * MESSAGES_PER_THREAD;
+	const double sent_per_second = static_cast<double>(sent) * 1e9 /
+	                               static_cast<double>(elapsed_ns);
+	std::cout << "[ BENCH    ] sessions=" << num_sessions
+	          << " threads=" << num_threads << ": " << sent_per_second
+	          << " msg/s sent, " << received << "/" << sent << " received"
+	          << std::endl;
+	EXPECT_GT(received, 0);
+}
+
+INSTANTIATE_TEST_SUITE_P(SessionsAndThreads,  // NOLINT
+                         SendStripingBenchmark,
+                         testing::Combine(testing::Values(1, 2, 4),
+                                          testing::Values(1, 2, 4, 8)));
+
+}  // namespace uprotocol
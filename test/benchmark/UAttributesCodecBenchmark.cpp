@@ -0,0 +1,114 @@
+// SPDX-FileCopyrightText: 2024 Contributors to the Eclipse Foundation
+//
+// See the NOTICE file(s) distributed with this work for additional
+// information regarding copyright ownership.
+//
+// This program and the accompanying materials are made available under the
+// terms of the Apache License Version 2.0 which is available at
+// https://www.apache.org/licenses/LICENSE-2.0
+//
+// SPDX-License-Identifier: Apache-2.0
+
+#include <gtest/gtest.h>
+
+#include <iostream>
+#include <vector>
+
+#include "BenchmarkUtils.h"
+#include "up-transport-zenoh-cpp/UAttributesCodec.h"
+
+namespace uprotocol {
+
+using transport::UAttributesCodec;
+
+constexpr size_t NUM_ITERATIONS = 1000000;
+
+class UAttributesCodecBenchmark : public testing::Test {
+protected:
+	// Run once per TEST_F.
+	// Used to set up clean environments per test.
+	void SetUp() override {}
+	void TearDown() override {}
+
+	// Run once per execution of the test application.
+	// Used for setup of all tests. Has access to this instance.
+	UAttributesCodecBenchmark() = default;
+
+	// Run once per execution of the test application.
+	// Used only for global setup outside of tests.
+	static void SetUpTestSuite() {}
+	static void TearDownTestSuite() {}
+
+public:
+	~UAttributesCodecBenchmark() override = default;
+};
+
+// Attributes of a typical RPC request, which has most fields set
+v1::UAttributes makeRequestAttributes() {
+	v1::UAttributes attributes;
+	attributes.mutable_id()->set_msb(0x0192B7A4E5F67000);
+	attributes.mutable_id()->set_lsb(0x8A1B2C3D4E5F6071);
+	attributes.set_type(v1::UMessageType::UMESSAGE_TYPE_REQUEST);
+	*attributes.mutable_source() = benchmark::makeUUri(0x10001, 0);
+	*attributes.mutable_sink() = benchmark::makeUUri(0x20002, 0x10);
+	attributes.set_priority(v1::UPriority::UPRIORITY_CS4);
+	attributes.set_ttl(1000);
+	attributes.set_payload_format(v1::UPayloadFormat::UPAYLOAD_FORMAT_PROTOBUF);
+	attributes.set_traceparent(
+	    "00-0af7651916cd43dd8448eb211c80319c-b7ad6b7169203331-01");
+	return attributes;
+}
+
+template <typename Operation>
+double nsPerOperation(Operation&& operation) {
+	const auto start = benchmark::nowNs();
+	for (size_t i = 0; i < NUM_ITERATIONS; ++i) {
+		operation();
+	}
+	return static_cast<double>(benchmark::nowNs() - start) /
+	       static_cast<double>(NUM_ITERATIONS);
+}
+
+TEST_F(UAttributesCodecBenchmark, Encode) {  // NOLINT
+	const auto attributes = makeRequestAttributes();
+	std::vector<uint8_t> buffer;
+
+	const double protobuf_ns = nsPerOperation([&]() {
+		buffer.resize(attributes.ByteSizeLong());
+		attributes.SerializeToArray(buffer.data(),
+		                            static_cast<int>(buffer.size()));
+	});
+	const auto protobuf_bytes = buffer;
+
+	const double codec_ns = nsPerOperation([&]() {
+		buffer.resize(UAttributesCodec::encodedSize(attributes));
+		UAttributesCodec::encode(attributes, buffer.data());
+	});
+	EXPECT_EQ(buffer, protobuf_bytes);
+
+	std::cout << "[ BENCH    ] encode " << buffer.size()
+	          << "B: protobuf=" << protobuf_ns << "ns codec=" << codec_ns
+	          << "ns" << std::endl;
+	EXPECT_LT(codec_ns, protobuf_ns);
+}
+
+TEST_F(UAttributesCodecBenchmark, Decode) {  // NOLINT
+	const auto bytes = makeRequestAttributes().SerializeAsString();
+	const auto* data = reinterpret_cast<const uint8_t*>(bytes.data());
+	v1::UAttributes attributes;
+
+	const double protobuf_ns = nsPerOperation([&]() {
+		attributes.ParseFromArray(data, static_cast<int>(bytes.size()));
+	});
+	const double codec_ns = nsPerOperation([&]() {
+		UAttributesCodec::decode(data, bytes.size(), attributes);
+	});
+	EXPECT_EQ(attributes.SerializeAsString(), bytes);
+
+	std::cout << "[ BENCH    ] decode " << bytes.size()
+	          << "B: protobuf=" << protobuf_ns << "ns codec=" << codec_ns
+	          << "ns" << std::endl;
+	EXPECT_LT(codec_ns, protobuf_ns);
+}
+
+}  // namespace uprotocol
@@ -0,0 +1,95 @@
+// SPDX-FileCopyrightText: 2024 Contributors to the Eclipse Foundation
+//
+// See the NOTICE file(s) distributed with this work for additional
+// information regarding copyright ownership.
+//
+// This program and the accompanying materials are made available under the
+// terms of the Apache License Version 2.0 which is available at
+// https://www.apache.org/licenses/LICENSE-2.0
+//
+// SPDX-License-Identifier: Apache-2.0
+
+#include <gtest/gtest.h>
+
+#include <ctime>
+
+#include "BenchmarkUtils.h"
+#include "up-transport-zenoh-cpp/ZenohUTransport.h"
+
+namespace uprotocol {
+
+constexpr std::string_view ZENOH_CONFIG_FILE = BUILD_REALPATH_ZENOH_CONF;
+
+constexpr uint32_t ENTITY_ID = 0x10001;
+constexpr uint16_t DIAGNOSTICS_TOPIC = 0x8000;
+constexpr size_t NUM_SENDS = 20000;
+
+class UnmatchedSendBenchmark : public testing::TestWithParam<size_t> {
+protected:
+	// Run once per TEST_P.
+	// Used to set up clean environments per test.
+	void SetUp() override {}
+	void TearDown() override {}
+
+	// Run once per execution of the test application.
+	// Used for setup of all tests. Has access to this instance.
+	UnmatchedSendBenchmark() { zenoh::init_log_from_env_or("error"); }
+
+	// Run once per execution of the test application.
+	// Used only for global setup outside of tests.
+	static void SetUpTestSuite() {}
+	static void TearDownTestSuite() {}
+
+public:
+	~UnmatchedSendBenchmark() override = default;
+};
+
+// CPU time consumed by this thread, in nanoseconds.
+int64_t threadCpuNs() {
+	constexpr int64_t NS_PER_SECOND = 1000000000;
+	timespec now{};
+	clock_gettime(CLOCK_THREAD_CPUTIME_ID, &now);
+	return (static_cast<int64_t>(now.tv_sec) * NS_PER_SECOND) + now.tv_nsec;
+}
+
+// Returns the CPU time per send to a topic nobody subscribes to.
+double measureUnmatchedSend(bool skip_unmatched_sends, size_t payload_size) {
+	transport::ZenohUTransportOptions options;
+	options.skip_unmatched_sends = skip_unmatched_sends;
+	auto transport = std::make_shared<transport::ZenohUTransport>(
+	    benchmark::makeUUri(ENTITY_ID, 0), ZENOH_CONFIG_FILE, options);
+
+	const auto message = benchmark::makePublishMessage(
+	    benchmark::makeUUri(ENTITY_ID, DIAGNOSTICS_TOPIC),
+	    std::string(payload_size, 'x'));
+
+	// Warm up, including the matching status lookup for the key
+	EXPECT_EQ(transport->send(message).code(), v1::UCode::OK);
+
+	const int64_t start = threadCpuNs();
+	for (size_t i = 0; i < NUM_SENDS; ++i) {
+		EXPECT_EQ(transport->send(message).code(), v1::UCode::OK);
+	}
+	return static_cast<double>(threadCpuNs() - start) /
+	       static_cast<double>(NUM_SENDS);
+}
+
+TEST_P(UnmatchedSendBenchmark, CpuPerSend) {  // NOLINT
+	const size_t payload_size = GetParam();
+
+	const double always_sent = measureUnmatchedSend(false, payload_size);
+	const double skipped = measureUnmatchedSend(true, payload_size);
+
+	std::cout << "[ BENCH    ] payload=" << payload_size
+	          << "B: cpu/send always sent=" << always_sent << "ns"
+	          << " skip unmatched=" << skipped << "ns" << std::endl;
+
+	if (transport::MatchingStatusCache::isSupported()) {
+		EXPECT_LT(skipped, always_sent);
+	}
+}
+
+INSTANTIATE_TEST_SUITE_P(PayloadSize, UnmatchedSendBenchmark,  // NOLINT
+                         testing::Values(64, 1024, 65536));
+
+}  // namespace uprotocol
@@ -0,0 +1,169 @@
+// SPDX-FileCopyrightText: 2024 Contributors to the Eclipse Foundation
+//
+// See the NOTICE file(s) distributed with this work for additional
+// information regarding copyright ownership.
+//
+// This program and the accompanying materials are made available under the
+// terms of the Apache License Version 2.0 which is available at
+// https://www.apache.org/licenses/LICENSE-2.0
+//
+// SPDX-License-Identifier: Apache-2.0
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "up-transport-zenoh-cpp/LatestValueMailbox.h"
+#include "up-transport-zenoh-cpp/SendConflator.h"
+
+namespace uprotocol {
+
+using transport::LatestValueMailbox;
+using transport::SendConflator;
+
+constexpr auto WAIT_TIMEOUT = std::chrono::seconds(5);
+constexpr auto INTERVAL = std::chrono::milliseconds(50);
+
+const std::string CONFLATED_KEY = "up/device/10001/1/8000/{}/{}/{}/{}";
+const std::string OTHER_KEY = "up/device/10001/1/8001/{}/{}/{}/{}";
+
+class TestConflation : public testing::Test {
+protected:
+	// Run once per TEST_F.
+	// Used to set up clean environments per test.
+	void SetUp() override {}
+	void TearDown() override {}
+
+	// Run once per execution of the test application.
+	// Used for setup of all tests. Has access to this instance.
+	TestConflation() = default;
+
+	// Run once per execution of the test application.
+	// Used only for global setup outside of tests.
+	static void SetUpTestSuite() {}
+	static void TearDownTestSuite() {}
+
+	static v1::UMessage makeMessage(const std::string& payload) {
+		v1::UMessage message;
+		message.set_payload(payload);
+		return message;
+	}
+
+	SendConflator::Flush recorder() {
+		return [this](const std::string&, const v1::UMessage& message) {
+			{
+				std::lock_guard<std::mutex> lock(mutex_);
+				flushed_.push_back(message.payload());
+			}
+			cv_.notify_all();
+		};
+	}
+
+	bool waitForFlushes(size_t count) {
+		std::unique_lock<std::mutex> lock(mutex_);
+		return cv_.wait_for(lock, WAIT_TIMEOUT, [this, count]() {
+			return flushed_.size() >= count;
+		});
+	}
+
+	std::vector<std::string> flushed() {
+		std::lock_guard<std::mutex> lock(mutex_);
+		return flushed_;
+	}
+
+public:
+	~TestConflation() override = default;
+
+private:
+	std::mutex mutex_;
+	std::condition_variable cv_;
+	std::vector<std::string> flushed_;
+};
+
+TEST_F(TestConflation, UnconflatedKeyIsSentNow) {  // NOLINT
+	SendConflator conflator({{CONFLATED_KEY, INTERVAL}}, recorder());
+
+	for (int i = 0; i < 10; ++i) {
+		EXPECT_EQ(conflator.offer(OTHER_KEY, makeMessage("x")),
+		          SendConflator::Action::SEND_NOW);
+	}
+	EXPECT_TRUE(conflator.conflated().empty());
+}
+
+TEST_F(TestConflation, OnlyLatestHeldMessageIsFlushed) {  // NOLINT
+	SendConflator conflator({{CONFLATED_KEY, INTERVAL}}, recorder());
+
+	EXPECT_EQ(conflator.offer(CONFLATED_KEY, makeMessage("1")),
+	          SendConflator::Action::SEND_NOW);
+	EXPECT_EQ(conflator.offer(CONFLATED_KEY, makeMessage("2")),
+	          SendConflator::Action::DEFERRED);
+	EXPECT_EQ(conflator.offer(CONFLATED_KEY, makeMessage("3")),
+	          SendConflator::Action::DEFERRED);
+
+	ASSERT_TRUE(waitForFlushes(1));
+	EXPECT_EQ(flushed(), std::vector<std::string>{"3"});
+	EXPECT_EQ(conflator.conflated().at(CONFLATED_KEY), 1);
+
+	// The flush counts as a send, so the next message is held again
+	EXPECT_EQ(conflator.offer(CONFLATED_KEY, makeMessage("4")),
+	          SendConflator::Action::DEFERRED);
+	ASSERT_TRUE(waitForFlushes(2));
+	EXPECT_EQ(flushed(), (std::vector<std::string>{"3", "4"}));
+}
+
+TEST_F(TestConflation, SendsAfterIntervalAreNotHeld) {  // NOLINT
+	SendConflator conflator({{CONFLATED_KEY, INTERVAL}}, recorder());
+
+	EXPECT_EQ(conflator.offer(CONFLATED_KEY, makeMessage("1")),
+	          SendConflator::Action::SEND_NOW);
+	std::this_thread::sleep_for(INTERVAL * 2);
+	EXPECT_EQ(conflator.offer(CONFLATED_KEY, makeMessage("2")),
+	          SendConflator::Action::SEND_NOW);
+	EXPECT_TRUE(flushed().empty());
+}
+
+TEST_F(TestConflation, HeldMessagesAreFlushedOnDestruction) {  // NOLINT
+	constexpr auto LONG_INTERVAL = std::chrono::hours(1);
+	{
+		SendConflator conflator({{CONFLATED_KEY, LONG_INTERVAL}}, recorder());
+		EXPECT_EQ(conflator.offer(CONFLATED_KEY, makeMessage("1")),
+		          SendConflator::Action::SEND_NOW);
+		EXPECT_EQ(conflator.offer(CONFLATED_KEY, makeMessage("2")),
+		          SendConflator::Action::DEFERRED);
+	}
+	EXPECT_EQ(flushed(), std::vector<std::string>{"2"});
+}
+
+TEST_F(TestConflation, MailboxKeepsLatest) {  // NOLINT
+	auto mailbox = LatestValueMailbox::create();
+	auto listener = mailbox->listener();
+
+	EXPECT_FALSE(mailbox->take().has_value());
+
+	listener(makeMessage("1"));
+	listener(makeMessage("2"));
+	listener(makeMessage("3"));
+
+	auto latest = mailbox->take();
+	ASSERT_TRUE(latest.has_value());
+	EXPECT_EQ(latest->payload(), "3");
+	EXPECT_EQ(mailbox->overwritten(), 2);
+	EXPECT_FALSE(mailbox->take().has_value());
+
+	std::thread producer([&listener]() {
+		std::this_thread::sleep_for(INTERVAL);
+		listener(makeMessage("4"));
+	});
+	latest = mailbox->takeFor(std::chrono::duration_cast<
+	                          std::chrono::milliseconds>(WAIT_TIMEOUT));
+	producer.join();
+	ASSERT_TRUE(latest.has_value());
+	EXPECT_EQ(latest->payload(), "4");
+}
+
+}  // namespace uprotocol
@@ -0,0 +1,130 @@
+// SPDX-FileCopyrightText: 2024 Contributors to the Eclipse Foundation
+//
+// See the NOTICE file(s) distributed with this work for additional
+// information regarding copyright ownership.
+//
+// This program and the accompanying materials are made available under the
+// terms of the Apache License Version 2.0 which is available at
+// https://www.apache.org/licenses/LICENSE-2.0
+//
+// SPDX-License-Identifier: Apache-2.0
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+#include "up-transport-zenoh-cpp/DuplicateFilter.h"
+
+namespace uprotocol {
+
+using transport::DuplicateFilter;
+
+class TestDuplicateFilter : public testing::Test {
+protected:
+	// Run once per TEST_F.
+	// Used to set up clean environments per test.
+	void SetUp() override {}
+	void TearDown() override {}
+
+	// Run once per execution of the test application.
+	// Used for setup of all tests. Has access to this instance.
+	TestDuplicateFilter() = default;
+
+	// Run once per execution of the test application.
+	// Used only for global setup outside of tests.
+	static void SetUpTestSuite() {}
+	static void TearDownTestSuite() {}
+
+	static v1::UUID makeId(uint64_t counter) {
+		constexpr uint64_t MSB = 0x0190A1B2C3D47000ULL;
+		constexpr uint64_t LSB_VARIANT = 0x8000000000000000ULL;
+		v1::UUID id;
+		id.set_msb(MSB);
+		id.set_lsb(LSB_VARIANT | counter);
+		return id;
+	}
+
+public:
+	~TestDuplicateFilter() override = default;
+};
+
+TEST_F(TestDuplicateFilter, DetectsRepeatedIds) {  // NOLINT
+	DuplicateFilter filter({});
+	const auto now = DuplicateFilter::Clock::now();
+
+	EXPECT_FALSE(filter.isDuplicate(makeId(1), now));
+	EXPECT_FALSE(filter.isDuplicate(makeId(2), now));
+	EXPECT_TRUE(filter.isDuplicate(makeId(1), now));
+	EXPECT_TRUE(filter.isDuplicate(makeId(2), now));
+	EXPECT_TRUE(filter.isDuplicate(makeId(2), now));
+	EXPECT_EQ(filter.suppressed(), 3);
+
+	// The nil id is never a duplicate
+	EXPECT_FALSE(filter.isDuplicate(v1::UUID{}, now));
+	EXPECT_FALSE(filter.isDuplicate(v1::UUID{}, now));
+}
+
+TEST_F(TestDuplicateFilter, ForgetsIdsAfterWindow) {  // NOLINT
+	DuplicateFilter::Config config;
+	config.window = std::chrono::milliseconds(100);
+	DuplicateFilter filter(config);
+	const auto now = DuplicateFilter::Clock::now();
+
+	EXPECT_FALSE(filter.isDuplicate(makeId(1), now));
+	EXPECT_TRUE(filter.isDuplicate(makeId(1), now + config.window / 2));
+	EXPECT_FALSE(filter.isDuplicate(makeId(1), now + config.window));
+	// Seeing it again restarted its window
+	EXPECT_TRUE(filter.isDuplicate(makeId(1), now + config.window * 3 / 2));
+}
+
+TEST_F(TestDuplicateFilter, BoundedCapacity) {  // NOLINT
+	constexpr size_t CAPACITY = 64;
+	constexpr size_t NUM_IDS = 10000;
+	DuplicateFilter::Config config;
+	config.capacity = CAPACITY;
+	config.shards = 4;
+	config.window = std::chrono::hours(1);
+	DuplicateFilter filter(config);
+	const auto start = DuplicateFilter::Clock::now();
+
+	for (size_t i = 0; i < NUM_IDS; ++i) {
+		EXPECT_FALSE(filter.isDuplicate(makeId(i),
+		                                start + std::chrono::microseconds(i)));
+	}
+	// The oldest ids made room for newer ones
+	const auto later = start + std::chrono::microseconds(NUM_IDS);
+	EXPECT_TRUE(filter.isDuplicate(makeId(NUM_IDS - 1), later));
+	EXPECT_FALSE(filter.isDuplicate(makeId(0), later));
+	EXPECT_FALSE(filter.isDuplicate(makeId(NUM_IDS - CAPACITY * 2), later));
+}
+
+TEST_F(TestDuplicateFilter, ConcurrentCallers) {  // NOLINT
+	constexpr size_t NUM_THREADS = 4;
+	constexpr size_t NUM_IDS = 1000;
+	DuplicateFilter::Config config;
+	config.capacity = NUM_THREADS * NUM_IDS * 2;
+	DuplicateFilter filter(config);
+
+	// Every thread sees every id, so each id gets through exactly once
+	std::atomic<size_t> passed = 0;
+	std::vector<std::thread> threads;
+	for (size_t thread = 0; thread < NUM_THREADS; ++thread) {
+		threads.emplace_back([&filter, &passed]() {
+			for (size_t i = 1; i <= NUM_IDS; ++i) {
+				if (!filter.isDuplicate(makeId(i))) {
+					++passed;
+				}
+			}
+		});
+	}
+	for (auto& thread : threads) {
+		thread.join();
+	}
+	EXPECT_EQ(passed, NUM_IDS);
+	EXPECT_EQ(filter.suppressed(), (NUM_THREADS - 1) * NUM_IDS);
+}
+
+}  // namespace uprotocol
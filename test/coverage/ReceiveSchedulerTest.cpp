@@ -0,0 +1,165 @@
+// SPDX-FileCopyrightText: 2024 Contributors to the Eclipse Foundation
+//
+// See the NOTICE file(s) distributed with this work for additional
+// information regarding copyright ownership.
+//
+// This program and the accompanying materials are made available under the
+// terms of the Apache License Version 2.0 which is available at
+// https://www.apache.org/licenses/LICENSE-2.0
+//
+// SPDX-License-Identifier: Apache-2.0
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <future>
+#include <mutex>
+#include <vector>
+
+#include "up-transport-zenoh-cpp/ReceiveScheduler.h"
+
+namespace uprotocol {
+
+using transport::ReceiveScheduler;
+
+constexpr auto WAIT_TIMEOUT = std::chrono::seconds(5);
+
+class TestReceiveScheduler : public testing::Test {
+protected:
+	// Run once per TEST_F.
+	// Used to set up clean environments per test.
+	void SetUp() override {}
+	void TearDown() override {}
+
+	// Run once per execution of the test application.
+	// Used for setup of all tests. Has access to this instance.
+	TestReceiveScheduler() = default;
+
+	// Run once per execution of the test application.
+	// Used only for global setup outside of tests.
+	static void SetUpTestSuite() {}
+	static void TearDownTestSuite() {}
+
+	// Posts a task that blocks its lane until release() is called, and
+	// waits until the task has started.
+	void block(ReceiveScheduler& scheduler, v1::UPriority priority) {
+		std::promise<void> started;
+		auto started_future = started.get_future();
+		ASSERT_TRUE(scheduler.post(
+		    priority, [&started, release = release_.get_future().share()]() {
+			    started.set_value();
+			    release.wait();
+		    }));
+		ASSERT_EQ(started_future.wait_for(WAIT_TIMEOUT),
+		          std::future_status::ready);
+	}
+
+	void release() { release_.set_value(); }
+
+	// Posts a task that records its priority when run.
+	void record(ReceiveScheduler& scheduler, v1::UPriority priority) {
+		EXPECT_TRUE(scheduler.post(priority, [this, priority]() {
+			std::lock_guard<std::mutex> lock(order_mutex_);
+			order_.push_back(priority);
+		}));
+	}
+
+	// Waits until `count` recorded tasks have run and returns their order.
+	std::vector<v1::UPriority> order(size_t count) {
+		const auto deadline = std::chrono::steady_clock::now() + WAIT_TIMEOUT;
+		while (std::chrono::steady_clock::now() < deadline) {
+			{
+				std::lock_guard<std::mutex> lock(order_mutex_);
+				if (order_.size() >= count) {
+					return order_;
+				}
+			}
+			std::this_thread::sleep_for(std::chrono::milliseconds(1));
+		}
+		std::lock_guard<std::mutex> lock(order_mutex_);
+		return order_;
+	}
+
+private:
+	std::promise<void> release_;
+	std::mutex order_mutex_;
+	std::vector<v1::UPriority> order_;
+
+public:
+	~TestReceiveScheduler() override = default;
+};
+
+TEST_F(TestReceiveScheduler, StrictPriorityOrder) {  // NOLINT
+	ReceiveScheduler scheduler(ReceiveScheduler::Config{});
+
+	block(scheduler, v1::UPriority::UPRIORITY_CS0);
+	record(scheduler, v1::UPriority::UPRIORITY_CS0);
+	record(scheduler, v1::UPriority::UPRIORITY_CS3);
+	record(scheduler, v1::UPriority::UPRIORITY_UNSPECIFIED);
+	record(scheduler, v1::UPriority::UPRIORITY_CS6);
+	release();
+
+	const std::vector<v1::UPriority> expected = {
+	    v1::UPriority::UPRIORITY_CS6, v1::UPriority::UPRIORITY_CS3,
+	    v1::UPriority::UPRIORITY_UNSPECIFIED, v1::UPriority::UPRIORITY_CS0};
+	EXPECT_EQ(order(expected.size()), expected);
+}
+
+TEST_F(TestReceiveScheduler, WeightedOrder) {  // NOLINT
+	ReceiveScheduler::Config config;
+	config.policy = ReceiveScheduler::Policy::WEIGHTED;
+	config.weights = {1, 1, 1, 1, 1, 1, 1, 2};
+	ReceiveScheduler scheduler(config);
+
+	block(scheduler, v1::UPriority::UPRIORITY_CS2);
+	for (int i = 0; i < 3; ++i) {
+		record(scheduler, v1::UPriority::UPRIORITY_CS6);
+		record(scheduler, v1::UPriority::UPRIORITY_CS0);
+	}
+	release();
+
+	// CS6 gets two turns for each turn CS0 gets
+	const std::vector<v1::UPriority> expected = {
+	    v1::UPriority::UPRIORITY_CS6, v1::UPriority::UPRIORITY_CS6,
+	    v1::UPriority::UPRIORITY_CS0, v1::UPriority::UPRIORITY_CS6,
+	    v1::UPriority::UPRIORITY_CS0, v1::UPriority::UPRIORITY_CS0};
+	EXPECT_EQ(order(expected.size()), expected);
+}
+
+TEST_F(TestReceiveScheduler, FullQueueDrops) {  // NOLINT
+	ReceiveScheduler::Config config;
+	config.queue_capacity = 1;
+	ReceiveScheduler scheduler(config);
+
+	block(scheduler, v1::UPriority::UPRIORITY_CS0);
+	EXPECT_TRUE(scheduler.post(v1::UPriority::UPRIORITY_CS0, []() {}));
+	EXPECT_FALSE(scheduler.post(v1::UPriority::UPRIORITY_CS0, []() {}));
+	// Other priorities have their own queue
+	EXPECT_TRUE(scheduler.post(v1::UPriority::UPRIORITY_CS1, []() {}));
+	EXPECT_EQ(scheduler.dropped(), 1);
+	release();
+}
+
+TEST_F(TestReceiveScheduler, HighPriorityLaneNotBlocked) {  // NOLINT
+	ReceiveScheduler::Config config;
+	config.dedicated_high_priority_lane = true;
+	config.high_priority_threshold = v1::UPriority::UPRIORITY_CS5;
+	config.high_priority_cpu = 0;
+	ReceiveScheduler scheduler(config);
+
+	block(scheduler, v1::UPriority::UPRIORITY_CS4);
+
+	std::promise<std::thread::id> ran_on;
+	auto ran_on_future = ran_on.get_future();
+	EXPECT_TRUE(scheduler.post(v1::UPriority::UPRIORITY_CS5, [&ran_on]() {
+		ran_on.set_value(std::this_thread::get_id());
+	}));
+
+	// Runs while the normal lane is still blocked
+	ASSERT_EQ(ran_on_future.wait_for(WAIT_TIMEOUT),
+	          std::future_status::ready);
+	EXPECT_NE(ran_on_future.get(), std::this_thread::get_id());
+	release();
+}
+
+}  // namespace uprotocol
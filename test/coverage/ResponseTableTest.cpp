@@ -0,0 +1,120 @@
+// SPDX-FileCopyrightText: 2024 Contributors to the Eclipse Foundation
+//
+// See the NOTICE file(s) distributed with this work for additional
+// information regarding copyright ownership.
+//
+// This program and the accompanying materials are made available under the
+// terms of the Apache License Version 2.0 which is available at
+// https://www.apache.org/licenses/LICENSE-2.0
+//
+// SPDX-License-Identifier: Apache-2.0
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <future>
+
+#include "up-transport-zenoh-cpp/ResponseTable.h"
+
+namespace uprotocol {
+
+using transport::ResponseTable;
+
+constexpr auto WAIT_TIMEOUT = std::chrono::seconds(5);
+constexpr auto LONG_TTL = std::chrono::milliseconds(60000);
+constexpr auto SHORT_TTL = std::chrono::milliseconds(20);
+
+class TestResponseTable : public testing::Test {
+protected:
+	// Run once per TEST_F.
+	// Used to set up clean environments per test.
+	void SetUp() override {}
+	void TearDown() override {}
+
+	// Run once per execution of the test application.
+	// Used for setup of all tests. Has access to this instance.
+	TestResponseTable() = default;
+
+	// Run once per execution of the test application.
+	// Used only for global setup outside of tests.
+	static void SetUpTestSuite() {}
+	static void TearDownTestSuite() {}
+
+	static v1::UUID makeUuid(uint64_t lsb) {
+		v1::UUID uuid;
+		uuid.set_msb(0x0123456789AB7000);
+		uuid.set_lsb(lsb);
+		return uuid;
+	}
+
+	static v1::UUri makeUri(uint32_t ue_id) {
+		v1::UUri uri;
+		uri.set_authority_name("responder");
+		uri.set_ue_id(ue_id);
+		uri.set_ue_version_major(1);
+		uri.set_resource_id(0x10);
+		return uri;
+	}
+
+public:
+	~TestResponseTable() override = default;
+};
+
+TEST_F(TestResponseTable, TakeReturnsHandlerOnce) {  // NOLINT
+	ResponseTable table;
+	const auto reqid = makeUuid(1);
+
+	bool called = false;
+	EXPECT_TRUE(table.expect(reqid, makeUri(1), LONG_TTL, [&called](auto) {
+		called = true;
+	}));
+	EXPECT_FALSE(table.expect(reqid, makeUri(1), LONG_TTL, [](auto) {}));
+	EXPECT_EQ(table.size(), 1);
+
+	EXPECT_FALSE(table.take(makeUuid(2)).has_value());
+
+	auto handler = table.take(reqid, makeUri(1));
+	ASSERT_TRUE(handler.has_value());
+	(*handler)(v1::UMessage{});
+	EXPECT_TRUE(called);
+	EXPECT_FALSE(table.take(reqid).has_value());
+	EXPECT_EQ(table.size(), 0);
+}
+
+TEST_F(TestResponseTable, OnlyExpectedResponderIsAccepted) {  // NOLINT
+	ResponseTable table;
+	const auto reqid = makeUuid(1);
+	EXPECT_TRUE(table.expect(reqid, makeUri(1), LONG_TTL, [](auto) {}));
+
+	EXPECT_FALSE(table.take(reqid, makeUri(2)).has_value());
+	auto other_authority = makeUri(1);
+	other_authority.set_authority_name("spoofer");
+	EXPECT_FALSE(table.take(reqid, other_authority).has_value());
+	EXPECT_EQ(table.size(), 1);
+
+	EXPECT_TRUE(table.take(reqid, makeUri(1)).has_value());
+	EXPECT_EQ(table.size(), 0);
+}
+
+TEST_F(TestResponseTable, ExpiredHandlerGetsDeadlineExceeded) {  // NOLINT
+	ResponseTable table;
+	std::promise<v1::UCode> result;
+	auto result_future = result.get_future();
+
+	// Registered first, but expires last
+	EXPECT_TRUE(table.expect(makeUuid(1), makeUri(1), LONG_TTL, [](auto) {}));
+	EXPECT_TRUE(table.expect(
+	    makeUuid(2), makeUri(1), SHORT_TTL,
+	    [&result](ResponseTable::ResponseOrStatus response_or_status) {
+		    result.set_value(response_or_status.has_value()
+		                         ? v1::UCode::OK
+		                         : response_or_status.error().code());
+	    }));
+
+	ASSERT_EQ(result_future.wait_for(WAIT_TIMEOUT), std::future_status::ready);
+	EXPECT_EQ(result_future.get(), v1::UCode::DEADLINE_EXCEEDED);
+	EXPECT_FALSE(table.take(makeUuid(2)).has_value());
+	EXPECT_TRUE(table.take(makeUuid(1)).has_value());
+}
+
+}  // namespace uprotocol
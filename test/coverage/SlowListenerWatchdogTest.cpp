@@ -0,0 +1,167 @@
+// SPDX-FileCopyrightText: 2024 Contributors to the Eclipse Foundation
+//
+// See the NOTICE file(s) distributed with this work for additional
+// information regarding copyright ownership.
+//
+// This program and the accompanying materials are made available under the
+// terms of the Apache License Version 2.0 which is available at
+// https://www.apache.org/licenses/LICENSE-2.0
+//
+// SPDX-License-Identifier: Apache-2.0
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <string>
+#include <vector>
+
+#include "up-transport-zenoh-cpp/SlowListenerWatchdog.h"
+
+namespace uprotocol {
+
+using std::chrono::milliseconds;
+using transport::SlowListenerCall;
+using transport::SlowListenerConfig;
+
+class TestSlowListenerWatchdog : public testing::Test {
+protected:
+	// Run once per TEST_F.
+	// Used to set up clean environments per test.
+	void SetUp() override {}
+	void TearDown() override {}
+
+	// Run once per execution of the test application.
+	// Used for setup of all tests. Has access to this instance.
+	TestSlowListenerWatchdog() = default;
+
+	// Run once per execution of the test application.
+	// Used only for global setup outside of tests.
+	static void SetUpTestSuite() {}
+	static void TearDownTestSuite() {}
+
+	static v1::UUri makeFilter(uint32_t resource_id) {
+		v1::UUri filter;
+		filter.set_authority_name("test0");
+		filter.set_ue_id(0x10001);
+		filter.set_ue_version_major(1);
+		filter.set_resource_id(resource_id);
+		return filter;
+	}
+
+public:
+	~TestSlowListenerWatchdog() override = default;
+};
+
+// Listeners are identified by any ordered type, here plain ints
+using Watchdog = transport::SlowListenerWatchdog<int>;
+
+TEST_F(TestSlowListenerWatchdog, ReportsSlowCalls) {  // NOLINT
+	std::vector<std::pair<std::string, uint64_t>> reports;
+	SlowListenerConfig config;
+	config.threshold = milliseconds(10);
+	config.hook = [&reports](const SlowListenerCall& call) {
+		reports.emplace_back(call.zenoh_key, call.listener_id);
+		EXPECT_FALSE(call.offloaded);
+	};
+	Watchdog watchdog(config);
+	watchdog.watch(1, makeFilter(0x8000), std::nullopt);
+	watchdog.watch(7, makeFilter(0x8001), std::nullopt);
+
+	EXPECT_FALSE(watchdog.check("a", 1, milliseconds(9)).has_value());
+	auto slow = watchdog.check("a", 1, milliseconds(10));
+	ASSERT_TRUE(slow.has_value());
+	EXPECT_EQ(slow->listener_id, 1);
+	EXPECT_EQ(slow->duration, milliseconds(10));
+
+	// Ids are assigned in the order listeners are first slow, and kept
+	EXPECT_TRUE(watchdog.check("b", 7, milliseconds(20)).has_value());
+	EXPECT_TRUE(watchdog.check("a", 1, milliseconds(30)).has_value());
+	EXPECT_EQ(reports,
+	          (std::vector<std::pair<std::string, uint64_t>>{
+	              {"a", 1}, {"b", 2}, {"a", 1}}));
+	EXPECT_FALSE(watchdog.isOffloaded(1));
+
+	const auto slow_calls = watchdog.slowCalls();
+	ASSERT_EQ(slow_calls.size(), 2);
+	EXPECT_EQ(slow_calls.at("a").count, 2);
+	EXPECT_EQ(slow_calls.at("a").max, milliseconds(30));
+	EXPECT_EQ(slow_calls.at("b").count, 1);
+}
+
+TEST_F(TestSlowListenerWatchdog, OffloadsSlowListeners) {  // NOLINT
+	SlowListenerConfig config;
+	config.threshold = milliseconds(10);
+	config.offload = true;
+	Watchdog watchdog(config);
+	watchdog.watch(1, makeFilter(0x8000), std::nullopt);
+
+	watchdog.check("a", 1, milliseconds(1));
+	EXPECT_FALSE(watchdog.isOffloaded(1));
+
+	auto slow = watchdog.check("a", 1, milliseconds(50));
+	ASSERT_TRUE(slow.has_value());
+	EXPECT_TRUE(slow->offloaded);
+	EXPECT_TRUE(watchdog.isOffloaded(1));
+	EXPECT_FALSE(watchdog.isOffloaded(2));
+
+	// A call still running when its listener is forgotten is reported,
+	// without tracking the listener again
+	watchdog.forget(1);
+	EXPECT_FALSE(watchdog.isOffloaded(1));
+	slow = watchdog.check("a", 1, milliseconds(50));
+	ASSERT_TRUE(slow.has_value());
+	EXPECT_EQ(slow->listener_id, 0);
+	EXPECT_FALSE(slow->offloaded);
+	EXPECT_FALSE(watchdog.isOffloaded(1));
+
+	// A listener watched again starts over with a new id
+	watchdog.watch(1, makeFilter(0x8000), std::nullopt);
+	slow = watchdog.check("a", 1, milliseconds(50));
+	ASSERT_TRUE(slow.has_value());
+	EXPECT_EQ(slow->listener_id, 2);
+	EXPECT_TRUE(watchdog.isOffloaded(1));
+}
+
+TEST_F(TestSlowListenerWatchdog, ReportsFilters) {  // NOLINT
+	SlowListenerConfig config;
+	config.threshold = milliseconds(10);
+	Watchdog watchdog(config);
+
+	const auto source = makeFilter(0x8000);
+	const auto sink = makeFilter(0);
+
+	// Watching a listener doesn't make it slow
+	watchdog.watch(1, source, std::nullopt);
+	watchdog.watch(2, source, sink);
+	EXPECT_FALSE(watchdog.check("a", 1, milliseconds(1)).has_value());
+
+	auto slow = watchdog.check("b", 2, milliseconds(10));
+	ASSERT_TRUE(slow.has_value());
+	EXPECT_EQ(slow->listener_id, 1);
+	ASSERT_TRUE(slow->source_filter.has_value());
+	EXPECT_EQ(slow->source_filter->SerializeAsString(),
+	          source.SerializeAsString());
+	ASSERT_TRUE(slow->sink_filter.has_value());
+	EXPECT_EQ(slow->sink_filter->SerializeAsString(),
+	          sink.SerializeAsString());
+
+	slow = watchdog.check("a", 1, milliseconds(10));
+	ASSERT_TRUE(slow.has_value());
+	EXPECT_EQ(slow->listener_id, 2);
+	EXPECT_TRUE(slow->source_filter.has_value());
+	EXPECT_FALSE(slow->sink_filter.has_value());
+
+	// Listeners that aren't watched are reported without filters or id
+	slow = watchdog.check("c", 3, milliseconds(10));
+	ASSERT_TRUE(slow.has_value());
+	EXPECT_FALSE(slow->source_filter.has_value());
+	EXPECT_EQ(slow->listener_id, 0);
+
+	watchdog.forget(2);
+	slow = watchdog.check("b", 2, milliseconds(10));
+	ASSERT_TRUE(slow.has_value());
+	EXPECT_FALSE(slow->source_filter.has_value());
+	EXPECT_EQ(slow->listener_id, 0);
+}
+
+}  // namespace uprotocol
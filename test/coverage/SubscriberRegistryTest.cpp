@@ -0,0 +1,105 @@
+// SPDX-FileCopyrightText: 2024 Contributors to the Eclipse Foundation
+//
+// See the NOTICE file(s) distributed with this work for additional
+// information regarding copyright ownership.
+//
+// This program and the accompanying materials are made available under the
+// terms of the Apache License Version 2.0 which is available at
+// https://www.apache.org/licenses/LICENSE-2.0
+//
+// SPDX-License-Identifier: Apache-2.0
+
+#include <gtest/gtest.h>
+
+#include <memory>
+
+#include "up-transport-zenoh-cpp/SubscriberRegistry.h"
+
+namespace uprotocol {
+
+// Listeners are plain ints and subscriptions are identified by a name.
+using Registry = SubscriberRegistry<int, std::string>;
+
+class TestSubscriberRegistry : public testing::Test {
+protected:
+	// Run once per TEST_F.
+	// Used to set up clean environments per test.
+	void SetUp() override {}
+	void TearDown() override {}
+
+	// Run once per execution of the test application.
+	// Used for setup of all tests. Has access to this instance.
+	TestSubscriberRegistry() = default;
+
+	// Run once per execution of the test application.
+	// Used only for global setup outside of tests.
+	static void SetUpTestSuite() {}
+	static void TearDownTestSuite() {}
+
+	static Registry::Entry makeEntry(const std::string& key,
+	                                 Registry::Listeners listeners,
+	                                 const std::string& subscription) {
+		return {key, std::make_shared<Registry::ListenerSet>(listeners),
+		        subscription};
+	}
+
+public:
+	~TestSubscriberRegistry() override = default;
+};
+
+TEST_F(TestSubscriberRegistry, AttachOnlyToExistingKeys) {  // NOLINT
+	Registry registry;
+
+	auto entry = makeEntry("a", {1}, "sub_a");
+	auto listener_set = entry.listeners;
+	std::vector<Registry::Entry> entries;
+	entries.push_back(std::move(entry));
+	EXPECT_TRUE(registry.insert(std::move(entries)).empty());
+
+	const auto attached = registry.attach({{"a", {2, 3}}, {"b", {4}}});
+	EXPECT_EQ(attached, (std::vector<bool>{true, false}));
+	EXPECT_EQ(*listener_set->get(), (Registry::Listeners{1, 2, 3}));
+	EXPECT_EQ(registry.size(), 1);
+}
+
+TEST_F(TestSubscriberRegistry, InsertMergesConcurrentKeys) {  // NOLINT
+	Registry registry;
+
+	std::vector<Registry::Entry> first;
+	first.push_back(makeEntry("a", {1}, "sub_a1"));
+	auto listener_set = first.front().listeners;
+	EXPECT_TRUE(registry.insert(std::move(first)).empty());
+
+	// A second subscription on the same key hands its listeners over to
+	// the existing one and is returned as surplus.
+	std::vector<Registry::Entry> second;
+	second.push_back(makeEntry("a", {2}, "sub_a2"));
+	second.push_back(makeEntry("b", {3}, "sub_b"));
+	EXPECT_EQ(registry.insert(std::move(second)),
+	          (std::vector<std::string>{"sub_a2"}));
+	EXPECT_EQ(*listener_set->get(), (Registry::Listeners{1, 2}));
+	EXPECT_EQ(registry.size(), 2);
+}
+
+TEST_F(TestSubscriberRegistry, DetachReturnsLastSubscription) {  // NOLINT
+	Registry registry;
+
+	std::vector<Registry::Entry> entries;
+	entries.push_back(makeEntry("a", {1, 2}, "sub_a"));
+	auto listener_set = entries.front().listeners;
+	registry.insert(std::move(entries));
+
+	// Snapshots taken before a change are not modified by it
+	const auto before = listener_set->get();
+
+	EXPECT_FALSE(registry.detach(1).has_value());
+	EXPECT_EQ(*listener_set->get(), (Registry::Listeners{2}));
+	EXPECT_EQ(*before, (Registry::Listeners{1, 2}));
+
+	EXPECT_FALSE(registry.detach(3).has_value());
+	EXPECT_EQ(registry.detach(2), std::optional<std::string>("sub_a"));
+	EXPECT_EQ(registry.size(), 0);
+	EXPECT_FALSE(registry.detach(2).has_value());
+}
+
+}  // namespace uprotocol
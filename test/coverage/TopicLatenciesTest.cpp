@@ -0,0 +1,88 @@
+// SPDX-FileCopyrightText: 2024 Contributors to the Eclipse Foundation
+//
+// See the NOTICE file(s) distributed with this work for additional
+// information regarding copyright ownership.
+//
+// This program and the accompanying materials are made available under the
+// terms of the Apache License Version 2.0 which is available at
+// https://www.apache.org/licenses/LICENSE-2.0
+//
+// SPDX-License-Identifier: Apache-2.0
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+
+#include "up-transport-zenoh-cpp/TopicLatencies.h"
+
+namespace uprotocol {
+
+using std::chrono::microseconds;
+using std::chrono::nanoseconds;
+using transport::LatencyHistogram;
+using transport::TopicLatencies;
+
+class TestTopicLatencies : public testing::Test {
+protected:
+	// Run once per TEST_F.
+	// Used to set up clean environments per test.
+	void SetUp() override {}
+	void TearDown() override {}
+
+	// Run once per execution of the test application.
+	// Used for setup of all tests. Has access to this instance.
+	TestTopicLatencies() = default;
+
+	// Run once per execution of the test application.
+	// Used only for global setup outside of tests.
+	static void SetUpTestSuite() {}
+	static void TearDownTestSuite() {}
+
+public:
+	~TestTopicLatencies() override = default;
+};
+
+TEST_F(TestTopicLatencies, Buckets) {  // NOLINT
+	EXPECT_EQ(LatencyHistogram::bucketOf(nanoseconds(999)), 0);
+	EXPECT_EQ(LatencyHistogram::bucketOf(microseconds(1)), 1);
+	EXPECT_EQ(LatencyHistogram::bucketOf(microseconds(3)), 2);
+	EXPECT_EQ(LatencyHistogram::bucketOf(microseconds(4)), 3);
+	EXPECT_EQ(LatencyHistogram::bucketOf(std::chrono::hours(24 * 365)),
+	          LatencyHistogram::NUM_BUCKETS - 1);
+}
+
+TEST_F(TestTopicLatencies, Statistics) {  // NOLINT
+	LatencyHistogram histogram;
+	EXPECT_EQ(histogram.mean(), nanoseconds(0));
+	EXPECT_EQ(histogram.quantile(0.5), nanoseconds(0));
+
+	// Negative latencies come from clock offsets, and count as 0
+	histogram.add(nanoseconds(-5));
+	for (int i = 0; i < 98; ++i) {
+		histogram.add(microseconds(10));
+	}
+	histogram.add(microseconds(1000));
+
+	EXPECT_EQ(histogram.count, 100);
+	EXPECT_EQ(histogram.max, microseconds(1000));
+	EXPECT_EQ(histogram.mean(), nanoseconds(((98 * 10) + 1000) * 1000 / 100));
+	EXPECT_EQ(histogram.quantile(0.0), microseconds(1));
+	EXPECT_EQ(histogram.quantile(0.5), microseconds(16));
+	EXPECT_EQ(histogram.quantile(0.99), microseconds(16));
+	EXPECT_EQ(histogram.quantile(1.0), microseconds(1000));
+}
+
+TEST_F(TestTopicLatencies, PerTopic) {  // NOLINT
+	TopicLatencies latencies;
+	latencies.add("a", microseconds(1));
+	latencies.add("a", microseconds(3));
+	latencies.add("b", microseconds(5));
+
+	const auto snapshot = latencies.snapshot();
+	ASSERT_EQ(snapshot.size(), 2);
+	EXPECT_EQ(snapshot.at("a").count, 2);
+	EXPECT_EQ(snapshot.at("a").total, microseconds(4));
+	EXPECT_EQ(snapshot.at("b").count, 1);
+}
+
+}  // namespace uprotocol
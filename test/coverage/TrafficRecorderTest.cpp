@@ -0,0 +1,267 @@
+// SPDX-FileCopyrightText: 2024 Contributors to the Eclipse Foundation
+//
+// See the NOTICE file(s) distributed with this work for additional
+// information regarding copyright ownership.
+//
+// This program and the accompanying materials are made available under the
+// terms of the Apache License Version 2.0 which is available at
+// https://www.apache.org/licenses/LICENSE-2.0
+//
+// SPDX-License-Identifier: Apache-2.0
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <thread>
+#include <vector>
+
+#include "up-transport-zenoh-cpp/TrafficRecorder.h"
+#include "up-transport-zenoh-cpp/TrafficReplayer.h"
+
+namespace uprotocol {
+
+using transport::TrafficCapture;
+using transport::TrafficRecorder;
+using transport::TrafficReplayer;
+using Direction = transport::capture_format::Direction;
+
+constexpr size_t LARGE_CAPACITY = 1 << 20;
+
+// Keeps every message sent through it
+struct CollectingTransport : public transport::UTransport {
+	explicit CollectingTransport(const v1::UUri& uri) : UTransport(uri) {}
+
+	std::vector<v1::UMessage> sent;
+	std::vector<std::chrono::steady_clock::time_point> sent_at;
+
+protected:
+	v1::UStatus sendImpl(const v1::UMessage& message) override {
+		sent.push_back(message);
+		sent_at.push_back(std::chrono::steady_clock::now());
+		return {};
+	}
+
+	v1::UStatus registerListenerImpl(CallableConn&&, const v1::UUri&,
+	                                 std::optional<v1::UUri>&&) override {
+		v1::UStatus status;
+		status.set_code(v1::UCode::UNIMPLEMENTED);
+		return status;
+	}
+};
+
+class TestTrafficRecorder : public testing::Test {
+protected:
+	// Run once per TEST_F.
+	// Used to set up clean environments per test.
+	void SetUp() override {
+		file_ = std::filesystem::temp_directory_path() /
+		        ("TrafficRecorderTest-" +
+		         std::string(testing::UnitTest::GetInstance()
+		                         ->current_test_info()
+		                         ->name()) +
+		         ".cap");
+	}
+	void TearDown() override { std::filesystem::remove(file_); }
+
+	// Run once per execution of the test application.
+	// Used for setup of all tests. Has access to this instance.
+	TestTrafficRecorder() = default;
+
+	// Run once per execution of the test application.
+	// Used only for global setup outside of tests.
+	static void SetUpTestSuite() {}
+	static void TearDownTestSuite() {}
+
+	static v1::UUri makeUUri(uint32_t ue_id, uint32_t resource_id) {
+		v1::UUri uuri;
+		uuri.set_authority_name("test0");
+		uuri.set_ue_id(ue_id);
+		uuri.set_ue_version_major(1);
+		uuri.set_resource_id(resource_id);
+		return uuri;
+	}
+
+	static v1::UMessage makeMessage(uint32_t resource_id,
+	                                const std::string& payload) {
+		v1::UMessage message;
+		auto* attributes = message.mutable_attributes();
+		attributes->mutable_id()->set_msb(0x0123456789AB7000);
+		attributes->mutable_id()->set_lsb(0x8000000000000000 | resource_id);
+		attributes->set_type(v1::UMessageType::UMESSAGE_TYPE_PUBLISH);
+		*attributes->mutable_source() = makeUUri(0x10001, resource_id);
+		attributes->set_priority(v1::UPriority::UPRIORITY_CS1);
+		message.set_payload(payload);
+		return message;
+	}
+
+	static std::vector<TrafficCapture::Record> readAll(
+	    const std::filesystem::path& file) {
+		TrafficCapture capture(file);
+		std::vector<TrafficCapture::Record> records;
+		TrafficCapture::Record record;
+		while (capture.next(record)) {
+			records.push_back(record);
+		}
+		return records;
+	}
+
+	const std::filesystem::path& file() const { return file_; }
+
+private:
+	std::filesystem::path file_;
+
+public:
+	~TestTrafficRecorder() override = default;
+};
+
+TEST_F(TestTrafficRecorder, RoundTrip) {  // NOLINT
+	const std::vector<v1::UMessage> messages = {
+	    makeMessage(0x8000, "first"), makeMessage(0x8001, ""),
+	    makeMessage(0x8002, std::string(1000, 'x'))};
+	const auto before = std::chrono::system_clock::now();
+	{
+		TrafficRecorder recorder(file(), LARGE_CAPACITY);
+		recorder.record(Direction::SENT, messages[0]);
+		recorder.record(Direction::RECEIVED, messages[1]);
+		recorder.record(Direction::SENT, messages[2]);
+		EXPECT_EQ(recorder.recorded(), 3);
+		EXPECT_EQ(recorder.dropped(), 0);
+	}
+	// The capture is truncated to what was recorded
+	EXPECT_LT(std::filesystem::file_size(file()), LARGE_CAPACITY);
+
+	TrafficCapture capture(file());
+	EXPECT_GE(capture.startTime() + std::chrono::seconds(1), before);
+
+	const auto records = readAll(file());
+	ASSERT_EQ(records.size(), messages.size());
+	for (size_t i = 0; i < records.size(); ++i) {
+		EXPECT_EQ(records[i].message.SerializeAsString(),
+		          messages[i].SerializeAsString());
+		if (i > 0) {
+			EXPECT_GE(records[i].offset, records[i - 1].offset);
+		}
+	}
+	EXPECT_EQ(records[0].direction, Direction::SENT);
+	EXPECT_EQ(records[1].direction, Direction::RECEIVED);
+
+	// Reading can be restarted
+	TrafficCapture::Record record;
+	while (capture.next(record)) {
+	}
+	capture.rewind();
+	ASSERT_TRUE(capture.next(record));
+	EXPECT_EQ(record.message.payload(), "first");
+}
+
+TEST_F(TestTrafficRecorder, FullCaptureDropsRecords) {  // NOLINT
+	constexpr size_t SMALL_CAPACITY = 256;
+	{
+		TrafficRecorder recorder(file(), SMALL_CAPACITY);
+		recorder.record(Direction::SENT, makeMessage(0x8000, "fits"));
+		recorder.record(Direction::SENT,
+		                makeMessage(0x8001, std::string(SMALL_CAPACITY, 'x')));
+		recorder.record(Direction::SENT, makeMessage(0x8002, "too late"));
+		EXPECT_EQ(recorder.recorded(), 1);
+		EXPECT_EQ(recorder.dropped(), 2);
+	}
+
+	const auto records = readAll(file());
+	ASSERT_EQ(records.size(), 1);
+	EXPECT_EQ(records[0].message.payload(), "fits");
+}
+
+TEST_F(TestTrafficRecorder, ConcurrentRecordsAreKept) {  // NOLINT
+	constexpr size_t NUM_THREADS = 4;
+	constexpr size_t PER_THREAD = 1000;
+	{
+		TrafficRecorder recorder(file(), LARGE_CAPACITY);
+		std::vector<std::thread> threads;
+		for (size_t thread = 0; thread < NUM_THREADS; ++thread) {
+			threads.emplace_back([&recorder, thread]() {
+				const auto message = makeMessage(
+				    static_cast<uint32_t>(thread), std::to_string(thread));
+				for (size_t i = 0; i < PER_THREAD; ++i) {
+					recorder.record(Direction::SENT, message);
+				}
+			});
+		}
+		for (auto& thread : threads) {
+			thread.join();
+		}
+	}
+
+	std::vector<size_t> per_thread(NUM_THREADS);
+	for (const auto& record : readAll(file())) {
+		const auto thread = record.message.attributes().source().resource_id();
+		ASSERT_LT(thread, NUM_THREADS);
+		EXPECT_EQ(record.message.payload(), std::to_string(thread));
+		++per_thread[thread];
+	}
+	EXPECT_EQ(per_thread, std::vector<size_t>(NUM_THREADS, PER_THREAD));
+}
+
+TEST_F(TestTrafficRecorder, NotACaptureIsRejected) {  // NOLINT
+	std::ofstream(file()) << "definitely not a capture file";
+	EXPECT_THROW(TrafficCapture{file()}, std::runtime_error);
+	EXPECT_THROW(TrafficCapture{file().string() + ".missing"},
+	             std::system_error);
+}
+
+TEST_F(TestTrafficRecorder, ReplaySendsRecordedMessages) {  // NOLINT
+	const auto sent = makeMessage(0x8000, "sent");
+	const auto received = makeMessage(0x8001, "received");
+	{
+		TrafficRecorder recorder(file(), LARGE_CAPACITY);
+		recorder.record(Direction::SENT, sent);
+		recorder.record(Direction::RECEIVED, received);
+	}
+
+	TrafficReplayer::Options options;
+	options.speed = 0;
+	options.new_ids = false;
+	CollectingTransport transport(makeUUri(0x10001, 0));
+	auto stats = TrafficReplayer::replay(transport, file(), options);
+	EXPECT_EQ(stats.sent, 1);
+	EXPECT_EQ(stats.failed, 0);
+	ASSERT_EQ(transport.sent.size(), 1);
+	EXPECT_EQ(transport.sent[0].SerializeAsString(), sent.SerializeAsString());
+
+	options.replay_received = true;
+	options.new_ids = true;
+	transport.sent.clear();
+	stats = TrafficReplayer::replay(transport, file(), options);
+	EXPECT_EQ(stats.sent, 2);
+	ASSERT_EQ(transport.sent.size(), 2);
+	EXPECT_EQ(transport.sent[1].payload(), "received");
+	EXPECT_NE(transport.sent[0].attributes().id().SerializeAsString(),
+	          sent.attributes().id().SerializeAsString());
+}
+
+TEST_F(TestTrafficRecorder, ReplayKeepsTiming) {  // NOLINT
+	constexpr auto GAP = std::chrono::milliseconds(100);
+	{
+		TrafficRecorder recorder(file(), LARGE_CAPACITY);
+		recorder.record(Direction::SENT, makeMessage(0x8000, "a"));
+		std::this_thread::sleep_for(GAP);
+		recorder.record(Direction::SENT, makeMessage(0x8000, "b"));
+	}
+
+	auto replayed_gap = [this](double speed) {
+		TrafficReplayer::Options options;
+		options.speed = speed;
+		CollectingTransport transport(makeUUri(0x10001, 0));
+		TrafficReplayer::replay(transport, file(), options);
+		EXPECT_EQ(transport.sent_at.size(), 2);
+		return transport.sent_at.back() - transport.sent_at.front();
+	};
+
+	EXPECT_GE(replayed_gap(1.0), GAP);
+	const auto fast_gap = replayed_gap(4.0);
+	EXPECT_GE(fast_gap, GAP / 4);
+	EXPECT_LT(fast_gap, GAP);
+}
+
+}  // namespace uprotocol
@@ -0,0 +1,175 @@
+// SPDX-FileCopyrightText: 2024 Contributors to the Eclipse Foundation
+//
+// See the NOTICE file(s) distributed with this work for additional
+// information regarding copyright ownership.
+//
+// This program and the accompanying materials are made available under the
+// terms of the Apache License Version 2.0 which is available at
+// https://www.apache.org/licenses/LICENSE-2.0
+//
+// SPDX-License-Identifier: Apache-2.0
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <string>
+
+#include "up-transport-zenoh-cpp/TrafficShaper.h"
+
+namespace uprotocol {
+
+using transport::TrafficShaper;
+using Decision = TrafficShaper::Decision;
+
+constexpr size_t PAYLOAD_SIZE = 1000;
+constexpr double SLOW_RATE = 1.0;
+
+class TestTrafficShaper : public testing::Test {
+protected:
+	// Run once per TEST_F.
+	// Used to set up clean environments per test.
+	void SetUp() override {}
+	void TearDown() override {}
+
+	// Run once per execution of the test application.
+	// Used for setup of all tests. Has access to this instance.
+	TestTrafficShaper() = default;
+
+	// Run once per execution of the test application.
+	// Used only for global setup outside of tests.
+	static void SetUpTestSuite() {}
+	static void TearDownTestSuite() {}
+
+	// Fits a single message in its burst, then refills very slowly
+	static TrafficShaper::Rule makeRule(TrafficShaper::OverLimit over_limit) {
+		TrafficShaper::Rule rule;
+		rule.bytes_per_second = SLOW_RATE;
+		rule.burst_bytes = PAYLOAD_SIZE + (PAYLOAD_SIZE / 2);
+		rule.over_limit = over_limit;
+		return rule;
+	}
+
+	static v1::UMessage makeMessage(uint32_t ue_id, v1::UPriority priority) {
+		v1::UMessage message;
+		auto* attributes = message.mutable_attributes();
+		attributes->set_type(v1::UMessageType::UMESSAGE_TYPE_PUBLISH);
+		attributes->mutable_source()->set_ue_id(ue_id);
+		attributes->set_priority(priority);
+		message.set_payload(std::string(PAYLOAD_SIZE, 'x'));
+		return message;
+	}
+
+public:
+	~TestTrafficShaper() override = default;
+};
+
+TEST_F(TestTrafficShaper, RejectAndDrop) {  // NOLINT
+	auto reject = makeRule(TrafficShaper::OverLimit::REJECT);
+	reject.key_prefix = "up/a/";
+	auto drop = makeRule(TrafficShaper::OverLimit::DROP);
+	drop.key_prefix = "up/b/";
+	TrafficShaper shaper({reject, drop});
+
+	const auto message = makeMessage(1, v1::UPriority::UPRIORITY_CS1);
+	EXPECT_EQ(shaper.admit("up/a/1", message), Decision::SEND);
+	EXPECT_EQ(shaper.admit("up/a/1", message), Decision::REJECT);
+	EXPECT_EQ(shaper.admit("up/b/1", message), Decision::SEND);
+	EXPECT_EQ(shaper.admit("up/b/1", message), Decision::DROP);
+	EXPECT_EQ(shaper.admit("up/b/1", message), Decision::DROP);
+	// Not selected by any rule
+	EXPECT_EQ(shaper.admit("up/c/1", message), Decision::SEND);
+	EXPECT_EQ(shaper.admit("up/c/1", message), Decision::SEND);
+
+	const auto stats = shaper.stats();
+	ASSERT_EQ(stats.size(), 2);
+	EXPECT_EQ(stats[0].sent_messages, 1);
+	EXPECT_GT(stats[0].sent_bytes, PAYLOAD_SIZE);
+	EXPECT_EQ(stats[0].rejected, 1);
+	EXPECT_EQ(stats[0].dropped, 0);
+	EXPECT_EQ(stats[1].sent_messages, 1);
+	EXPECT_EQ(stats[1].dropped, 2);
+	EXPECT_LT(stats[1].available_bytes, static_cast<double>(PAYLOAD_SIZE));
+}
+
+TEST_F(TestTrafficShaper, Selectors) {  // NOLINT
+	auto by_priority = makeRule(TrafficShaper::OverLimit::REJECT);
+	by_priority.priority = v1::UPriority::UPRIORITY_CS0;
+	auto by_entity = makeRule(TrafficShaper::OverLimit::REJECT);
+	by_entity.source_entity = 7;
+	TrafficShaper shaper({by_priority, by_entity});
+
+	// The first matching rule is charged, so the entity rule is untouched
+	const auto low = makeMessage(7, v1::UPriority::UPRIORITY_CS0);
+	EXPECT_EQ(shaper.admit("up/x", low), Decision::SEND);
+	EXPECT_EQ(shaper.admit("up/x", low), Decision::REJECT);
+
+	const auto from_entity = makeMessage(7, v1::UPriority::UPRIORITY_CS4);
+	EXPECT_EQ(shaper.admit("up/x", from_entity), Decision::SEND);
+	EXPECT_EQ(shaper.admit("up/x", from_entity), Decision::REJECT);
+
+	const auto other = makeMessage(8, v1::UPriority::UPRIORITY_CS4);
+	EXPECT_EQ(shaper.admit("up/x", other), Decision::SEND);
+	EXPECT_EQ(shaper.admit("up/x", other), Decision::SEND);
+}
+
+TEST_F(TestTrafficShaper, DelayWaitsForTokens) {  // NOLINT
+	constexpr double RATE = 20000;  // One message every ~50ms
+	auto rule = makeRule(TrafficShaper::OverLimit::DELAY);
+	rule.bytes_per_second = RATE;
+	TrafficShaper shaper({rule});
+
+	const auto message = makeMessage(1, v1::UPriority::UPRIORITY_CS1);
+	const auto start = std::chrono::steady_clock::now();
+	for (int i = 0; i < 3; ++i) {
+		EXPECT_EQ(shaper.admit("up/x", message), Decision::SEND);
+	}
+	const auto elapsed = std::chrono::steady_clock::now() - start;
+
+	// The first message fits in the burst, the next two each wait
+	EXPECT_GE(elapsed, std::chrono::milliseconds(70));
+	const auto stats = shaper.stats();
+	EXPECT_EQ(stats[0].sent_messages, 3);
+	EXPECT_EQ(stats[0].delayed, 2);
+	EXPECT_GE(stats[0].total_delay, std::chrono::milliseconds(70));
+
+	// Waits longer than max_delay are rejected instead
+	rule.bytes_per_second = SLOW_RATE;
+	TrafficShaper slow({rule});
+	EXPECT_EQ(slow.admit("up/x", message), Decision::SEND);
+	EXPECT_EQ(slow.admit("up/x", message), Decision::REJECT);
+}
+
+TEST_F(TestTrafficShaper, LargerThanBurstIsChargedInFull) {  // NOLINT
+	constexpr double RATE = 20000;
+	constexpr size_t LARGE_SIZE = 4 * PAYLOAD_SIZE;
+	auto large = makeMessage(1, v1::UPriority::UPRIORITY_CS1);
+	large.set_payload(std::string(LARGE_SIZE, 'x'));
+	const auto small = makeMessage(1, v1::UPriority::UPRIORITY_CS1);
+
+	// A full bucket lets a large message through, but leaves a debt that
+	// rejects what follows
+	TrafficShaper reject({makeRule(TrafficShaper::OverLimit::REJECT)});
+	EXPECT_EQ(reject.admit("up/x", large), Decision::SEND);
+	EXPECT_EQ(reject.admit("up/x", small), Decision::REJECT);
+	auto stats = reject.stats();
+	EXPECT_GT(stats[0].sent_bytes, LARGE_SIZE);
+	EXPECT_LT(stats[0].available_bytes,
+	          -static_cast<double>(LARGE_SIZE - PAYLOAD_SIZE * 3 / 2));
+
+	// A delayed message waits for the whole debt, at ~20 bytes per ms:
+	// about 125ms for the large message beyond the burst, and 50ms for
+	// the small message itself.
+	auto rule = makeRule(TrafficShaper::OverLimit::DELAY);
+	rule.bytes_per_second = RATE;
+	TrafficShaper delay({rule});
+	const auto start = std::chrono::steady_clock::now();
+	EXPECT_EQ(delay.admit("up/x", large), Decision::SEND);
+	EXPECT_EQ(delay.admit("up/x", small), Decision::SEND);
+	EXPECT_GE(std::chrono::steady_clock::now() - start,
+	          std::chrono::milliseconds(150));
+	stats = delay.stats();
+	EXPECT_EQ(stats[0].sent_messages, 2);
+	EXPECT_EQ(stats[0].delayed, 1);
+}
+
+}  // namespace uprotocol
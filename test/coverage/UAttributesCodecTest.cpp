@@ -0,0 +1,289 @@
+// SPDX-FileCopyrightText: 2024 Contributors to the Eclipse Foundation
+//
+// See the NOTICE file(s) distributed with this work for additional
+// information regarding copyright ownership.
+//
+// This program and the accompanying materials are made available under the
+// terms of the Apache License Version 2.0 which is available at
+// https://www.apache.org/licenses/LICENSE-2.0
+//
+// SPDX-License-Identifier: Apache-2.0
+
+#include <gtest/gtest.h>
+
+#include <random>
+#include <string>
+#include <vector>
+
+#include "up-transport-zenoh-cpp/UAttributesCodec.h"
+
+namespace uprotocol {
+
+using transport::UAttributesCodec;
+
+constexpr size_t FUZZ_ITERATIONS = 20000;
+constexpr uint64_t FUZZ_SEED = 0x5eed;
+
+class TestUAttributesCodec : public testing::Test {
+protected:
+	// Run once per TEST_F.
+	// Used to set up clean environments per test.
+	void SetUp() override {}
+	void TearDown() override {}
+
+	// Run once per execution of the test application.
+	// Used for setup of all tests. Has access to this instance.
+	TestUAttributesCodec() = default;
+
+	// Run once per execution of the test application.
+	// Used only for global setup outside of tests.
+	static void SetUpTestSuite() {}
+	static void TearDownTestSuite() {}
+
+	bool coin() { return std::bernoulli_distribution(0.5)(random_); }
+
+	// Mostly small values, sometimes anything, to cover all varint lengths
+	uint32_t randomUint32() {
+		constexpr uint32_t SMALL = 300;
+		if (coin()) {
+			return std::uniform_int_distribution<uint32_t>(0, SMALL)(random_);
+		}
+		return std::uniform_int_distribution<uint32_t>()(random_);
+	}
+
+	// Includes unknown and negative enum values
+	int randomEnum() {
+		constexpr int MAX_KNOWN = 20;
+		if (coin()) {
+			return std::uniform_int_distribution<int>(0, MAX_KNOWN)(random_);
+		}
+		return std::uniform_int_distribution<int>()(random_);
+	}
+
+	// Valid UTF-8 of 1 to 4 bytes per character
+	std::string randomString() {
+		static const std::vector<std::string> CHARACTERS = {
+		    "a", "Z", "/", "é", "€", "\U0001F600", "߿"};
+		constexpr size_t MAX_LENGTH = 40;
+		const auto length =
+		    std::uniform_int_distribution<size_t>(0, MAX_LENGTH)(random_);
+		std::string value;
+		for (size_t i = 0; i < length; ++i) {
+			value += CHARACTERS[std::uniform_int_distribution<size_t>(
+			    0, CHARACTERS.size() - 1)(random_)];
+		}
+		return value;
+	}
+
+	void randomUuid(v1::UUID& uuid) {
+		if (coin()) {
+			uuid.set_msb(random_());
+		}
+		if (coin()) {
+			uuid.set_lsb(random_());
+		}
+	}
+
+	void randomUuri(v1::UUri& uuri) {
+		if (coin()) {
+			uuri.set_authority_name(randomString());
+		}
+		uuri.set_ue_id(randomUint32());
+		uuri.set_ue_version_major(randomUint32());
+		uuri.set_resource_id(randomUint32());
+	}
+
+	v1::UAttributes randomAttributes() {
+		v1::UAttributes attributes;
+		if (coin()) {
+			randomUuid(*attributes.mutable_id());
+		}
+		if (coin()) {
+			attributes.set_type(static_cast<v1::UMessageType>(randomEnum()));
+		}
+		if (coin()) {
+			randomUuri(*attributes.mutable_source());
+		}
+		if (coin()) {
+			randomUuri(*attributes.mutable_sink());
+		}
+		if (coin()) {
+			attributes.set_priority(static_cast<v1::UPriority>(randomEnum()));
+		}
+		if (coin()) {
+			attributes.set_ttl(randomUint32());
+		}
+		if (coin()) {
+			attributes.set_permission_level(randomUint32());
+		}
+		if (coin()) {
+			attributes.set_commstatus(static_cast<v1::UCode>(randomEnum()));
+		}
+		if (coin()) {
+			randomUuid(*attributes.mutable_reqid());
+		}
+		if (coin()) {
+			attributes.set_token(randomString());
+		}
+		if (coin()) {
+			attributes.set_traceparent(randomString());
+		}
+		if (coin()) {
+			attributes.set_payload_format(
+			    static_cast<v1::UPayloadFormat>(randomEnum()));
+		}
+		return attributes;
+	}
+
+	// Flips, overwrites, inserts or removes a few random bytes
+	void mutate(std::string& bytes) {
+		constexpr int MAX_MUTATIONS = 4;
+		const auto mutations =
+		    std::uniform_int_distribution<int>(1, MAX_MUTATIONS)(random_);
+		for (int i = 0; i < mutations; ++i) {
+			const auto position =
+			    std::uniform_int_distribution<size_t>(0, bytes.size())(random_);
+			const auto byte = static_cast<char>(
+			    std::uniform_int_distribution<int>(0, UINT8_MAX)(random_));
+			switch (std::uniform_int_distribution<int>(0, 3)(random_)) {
+				case 0:
+					bytes.insert(position, 1, byte);
+					break;
+				case 1:
+					bytes.resize(position);
+					break;
+				default:
+					if (position < bytes.size()) {
+						bytes[position] = byte;
+					}
+					break;
+			}
+		}
+	}
+
+	static std::string encode(const v1::UAttributes& attributes) {
+		std::string bytes(UAttributesCodec::encodedSize(attributes), '\0');
+		auto* begin = reinterpret_cast<uint8_t*>(bytes.data());
+		auto* end = UAttributesCodec::encode(attributes, begin);
+		EXPECT_EQ(static_cast<size_t>(end - begin), bytes.size());
+		return bytes;
+	}
+
+	static bool decode(const std::string& bytes, v1::UAttributes& attributes) {
+		return UAttributesCodec::decode(
+		    reinterpret_cast<const uint8_t*>(bytes.data()), bytes.size(),
+		    attributes);
+	}
+
+private:
+	std::mt19937_64 random_{FUZZ_SEED};
+
+public:
+	~TestUAttributesCodec() override = default;
+};
+
+TEST_F(TestUAttributesCodec, EncodeMatchesProtobuf) {  // NOLINT
+	for (size_t i = 0; i < FUZZ_ITERATIONS; ++i) {
+		const auto attributes = randomAttributes();
+		EXPECT_EQ(UAttributesCodec::encodedSize(attributes),
+		          attributes.ByteSizeLong());
+		ASSERT_EQ(encode(attributes), attributes.SerializeAsString())
+		    << attributes.DebugString();
+	}
+}
+
+TEST_F(TestUAttributesCodec, SinkInsertedAtOffsetMatchesEncode) {  // NOLINT
+	for (size_t i = 0; i < FUZZ_ITERATIONS; ++i) {
+		auto attributes = randomAttributes();
+		attributes.clear_sink();
+		v1::UUri sink;
+		randomUuri(sink);
+
+		const auto without_sink = encode(attributes);
+		const auto offset = UAttributesCodec::encodedSizeBeforeSink(attributes);
+		std::string sink_bytes(UAttributesCodec::encodedSinkSize(sink), '\0');
+		UAttributesCodec::encodeSink(
+		    sink, reinterpret_cast<uint8_t*>(sink_bytes.data()));
+
+		*attributes.mutable_sink() = sink;
+		ASSERT_EQ(without_sink.substr(0, offset) + sink_bytes +
+		              without_sink.substr(offset),
+		          encode(attributes))
+		    << attributes.DebugString();
+	}
+}
+
+TEST_F(TestUAttributesCodec, DecodeMatchesProtobuf) {  // NOLINT
+	// Decoding into the same object must not leave fields behind
+	v1::UAttributes decoded;
+	for (size_t i = 0; i < FUZZ_ITERATIONS; ++i) {
+		const auto attributes = randomAttributes();
+		ASSERT_TRUE(decode(attributes.SerializeAsString(), decoded));
+		ASSERT_EQ(decoded.SerializeAsString(), attributes.SerializeAsString())
+		    << attributes.DebugString();
+	}
+}
+
+TEST_F(TestUAttributesCodec, MutatedInputMatchesProtobuf) {  // NOLINT
+	size_t parsed = 0;
+	for (size_t i = 0; i < FUZZ_ITERATIONS; ++i) {
+		auto bytes = randomAttributes().SerializeAsString();
+		mutate(bytes);
+
+		v1::UAttributes expected;
+		const bool expected_ok = expected.ParseFromString(bytes);
+		v1::UAttributes decoded;
+		ASSERT_EQ(decode(bytes, decoded), expected_ok)
+		    << testing::PrintToString(
+		           std::vector<uint8_t>(bytes.begin(), bytes.end()));
+		if (!expected_ok) {
+			continue;
+		}
+		++parsed;
+
+		// The codec skips unknown fields instead of keeping them
+		expected.DiscardUnknownFields();
+		ASSERT_EQ(decoded.SerializeAsString(), expected.SerializeAsString());
+	}
+	// Make sure the comparison above isn't vacuous
+	EXPECT_GT(parsed, FUZZ_ITERATIONS / 10);
+}
+
+TEST_F(TestUAttributesCodec, UnknownFieldsAndGroupsAreSkipped) {  // NOLINT
+	v1::UAttributes attributes;
+	attributes.set_ttl(1);
+
+	// Field 13 as varint, field 1 (id) as fixed32, and field 20 as a group
+	// containing field 21 as fixed64
+	const std::string extra = {'\x68', '\x01', '\x0d', '\x01', '\x02',
+	                           '\x03', '\x04', '\xa3', '\x01', '\xa9',
+	                           '\x01', '\x01', '\x02', '\x03', '\x04',
+	                           '\x05', '\x06', '\x07', '\x08', '\xa4',
+	                           '\x01'};
+	const auto bytes = attributes.SerializeAsString() + extra;
+
+	v1::UAttributes decoded;
+	ASSERT_TRUE(decode(bytes, decoded));
+	EXPECT_FALSE(decoded.has_id());
+	EXPECT_EQ(decoded.ttl(), 1);
+
+	// A group without its end tag is invalid
+	EXPECT_FALSE(decode(bytes.substr(0, bytes.size() - 2), decoded));
+}
+
+TEST_F(TestUAttributesCodec, InvalidUtf8IsRejected) {  // NOLINT
+	// Overlong, surrogate, past U+10FFFF and truncated
+	const std::vector<std::string> invalid_strings = {
+	    "\xc0\xaf", "\xed\xa0\x80", "\xf4\x90\x80\x80", "\xe2\x82"};
+	for (const auto& invalid : invalid_strings) {
+		v1::UAttributes attributes;
+		attributes.set_token(invalid);
+		const auto bytes = encode(attributes);
+
+		v1::UAttributes decoded;
+		EXPECT_FALSE(decoded.ParseFromString(bytes));
+		EXPECT_FALSE(decode(bytes, decoded));
+	}
+}
+
+}  // namespace uprotocol
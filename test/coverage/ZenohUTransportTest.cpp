@@ -14,8 +14,21 @@
 #include <up-cpp/datamodel/serializer/UUri.h>
 #include <up-cpp/datamodel/validator/UUri.h>
 
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <filesystem>
+#include <future>
 #include <iostream>
+#include <map>
+#include <mutex>
+#include <set>
+#include <stdexcept>
+#include <thread>
 
+#include "LinkedConfigs.h"
+#include "up-transport-zenoh-cpp/TrafficReplayer.h"
 #include "up-transport-zenoh-cpp/ZenohUTransport.h"
 
 namespace uprotocol {
@@ -123,4 +136,1033 @@ TEST_F(TestZenohUTransport, toZenohKeyString) {  // NOLINT
 	          "up/my-default-authority/10AB/3/80CD/{}/{}/{}/{}");
 }
 
+struct ExposeIsExpired : public transport::ZenohUTransport {
+	template <typename... Args>
+	static auto isExpired(Args&&... args) {
+		return transport::ZenohUTransport::isExpired(
+		    std::forward<Args>(args)...);
+	}
+};
+
+// Builds a publish message whose id was created `age` ago
+v1::UMessage create_publish_message(const v1::UUri& topic,
+                                    std::chrono::milliseconds age,
+                                    std::optional<uint32_t> ttl) {
+	constexpr int UUID_TIMESTAMP_SHIFT = 16;
+	constexpr uint64_t UUID_VERSION_BITS_MASK = 0xFFFF;
+
+	const auto created = std::chrono::duration_cast<std::chrono::milliseconds>(
+	    std::chrono::system_clock::now().time_since_epoch() - age);
+	auto id = datamodel::builder::UuidBuilder::getBuilder().build();
+	id.set_msb((static_cast<uint64_t>(created.count())
+	            << UUID_TIMESTAMP_SHIFT) |
+	           (id.msb() & UUID_VERSION_BITS_MASK));
+
+	v1::UMessage message;
+	auto* attributes = message.mutable_attributes();
+	*attributes->mutable_id() = id;
+	attributes->set_type(v1::UMessageType::UMESSAGE_TYPE_PUBLISH);
+	*attributes->mutable_source() = topic;
+	attributes->set_priority(v1::UPriority::UPRIORITY_CS1);
+	attributes->set_payload_format(v1::UPayloadFormat::UPAYLOAD_FORMAT_TEXT);
+	if (ttl.has_value()) {
+		attributes->set_ttl(*ttl);
+	}
+	message.set_payload("payload");
+	return message;
+}
+
+TEST_F(TestZenohUTransport, isExpired) {  // NOLINT
+	const auto topic = create_uuri("test0", {0x10001, 1}, 0x8000);
+	const auto age = std::chrono::milliseconds(1000);
+
+	EXPECT_FALSE(ExposeIsExpired::isExpired(
+	    create_publish_message(topic, age, std::nullopt).attributes()));
+	EXPECT_FALSE(ExposeIsExpired::isExpired(
+	    create_publish_message(topic, age, 0).attributes()));
+	EXPECT_FALSE(ExposeIsExpired::isExpired(
+	    create_publish_message(topic, age, 5000).attributes()));
+	EXPECT_TRUE(ExposeIsExpired::isExpired(
+	    create_publish_message(topic, age, 500).attributes()));
+
+	const auto fresh = create_publish_message(topic, {}, 500).attributes();
+	EXPECT_FALSE(ExposeIsExpired::isExpired(fresh));
+	EXPECT_TRUE(ExposeIsExpired::isExpired(
+	    fresh, std::chrono::system_clock::now() + std::chrono::seconds(1)));
+}
+
+TEST_F(TestZenohUTransport, DropExpiredOnSend) {  // NOLINT
+	transport::ZenohUTransportOptions options;
+	options.drop_expired_on_send = true;
+	auto transport = std::make_shared<transport::ZenohUTransport>(
+	    create_uuri(ENTITY_URI_STR), ZENOH_CONFIG_FILE, options);
+
+	const auto topic = create_uuri("test0", {0x10001, 1}, 0x8000);
+	EXPECT_NE(transport
+	              ->send(create_publish_message(
+	                  topic, std::chrono::milliseconds(1000), 500))
+	              .code(),
+	          v1::UCode::OK);
+	EXPECT_EQ(transport->send(create_publish_message(topic, {}, 500)).code(),
+	          v1::UCode::OK);
+}
+
+TEST_F(TestZenohUTransport, DropExpiredOnReceive) {  // NOLINT
+	constexpr uint32_t SHORT_TTL_MS = 50;
+	constexpr auto SLOW_LISTENER_DELAY = std::chrono::milliseconds(200);
+
+	transport::ZenohUTransportOptions options;
+	options.receive_scheduler.emplace();
+	options.drop_expired_on_receive = true;
+	auto transport = std::make_shared<transport::ZenohUTransport>(
+	    create_uuri(ENTITY_URI_STR), ZENOH_CONFIG_FILE, options);
+
+	const auto slow_topic = create_uuri("test0", {0x10001, 1}, 0x8000);
+	const auto short_ttl_topic = create_uuri("test0", {0x10001, 1}, 0x8001);
+
+	// The slow listener holds up the receive queue long enough for the
+	// message after it to expire before it is dispatched.
+	auto slow_handle = transport->registerListener(
+	    [SLOW_LISTENER_DELAY](const v1::UMessage&) {
+		    std::this_thread::sleep_for(SLOW_LISTENER_DELAY);
+	    },
+	    slow_topic);
+	std::atomic<size_t> received = 0;
+	auto short_ttl_handle = transport->registerListener(
+	    [&received](const v1::UMessage&) { ++received; }, short_ttl_topic);
+	ASSERT_TRUE(slow_handle);
+	ASSERT_TRUE(short_ttl_handle);
+
+	auto slow = create_publish_message(slow_topic, {}, std::nullopt);
+	auto short_ttl =
+	    create_publish_message(short_ttl_topic, {}, SHORT_TTL_MS);
+	EXPECT_EQ(transport->send(slow).code(), v1::UCode::OK);
+	EXPECT_EQ(transport->send(short_ttl).code(), v1::UCode::OK);
+	std::this_thread::sleep_for(2 * SLOW_LISTENER_DELAY);
+
+	EXPECT_EQ(received, 0);
+	const auto drops = transport->getExpiredDrops();
+	EXPECT_TRUE(drops.on_send.empty());
+	const auto key =
+	    ExposeKeyString::toZenohKeyString("", short_ttl_topic, std::nullopt);
+	ASSERT_EQ(drops.on_receive.count(key), 1);
+	EXPECT_EQ(drops.on_receive.at(key), 1);
+}
+
+TEST_F(TestZenohUTransport, RegisterListeners) {  // NOLINT
+	auto transport = std::make_shared<transport::ZenohUTransport>(
+	    create_uuri(ENTITY_URI_STR), ZENOH_CONFIG_FILE);
+
+	const auto topic_a = create_uuri("test0", {0x10001, 1}, 0x8000);
+	const auto topic_b = create_uuri("test0", {0x10001, 1}, 0x8001);
+	const v1::UUri invalid;
+
+	std::array<std::atomic<size_t>, 3> received{};
+	std::vector<transport::ZenohUTransport::ListenerRegistration> to_register;
+	// Two listeners on the same key share one subscriber
+	to_register.push_back(
+	    {[&received](const v1::UMessage&) { ++received[0]; }, topic_a, {}});
+	to_register.push_back(
+	    {[&received](const v1::UMessage&) { ++received[1]; }, topic_a, {}});
+	to_register.push_back(
+	    {[&received](const v1::UMessage&) { ++received[2]; }, topic_b, {}});
+	to_register.push_back({[](const v1::UMessage&) {}, invalid, {}});
+
+	auto results = transport->registerListeners(std::move(to_register));
+	ASSERT_EQ(results.size(), 4);
+	EXPECT_TRUE(results[0]);
+	EXPECT_TRUE(results[1]);
+	EXPECT_TRUE(results[2]);
+	ASSERT_FALSE(results[3]);
+	EXPECT_EQ(results[3].error().code(), v1::UCode::INVALID_ARGUMENT);
+
+	auto message = create_publish_message(topic_a, {}, std::nullopt);
+	EXPECT_EQ(transport->send(message).code(), v1::UCode::OK);
+	EXPECT_EQ(received[0], 1);
+	EXPECT_EQ(received[1], 1);
+	EXPECT_EQ(received[2], 0);
+
+	// Unregistering one listener keeps the shared subscriber alive for the
+	// other one.
+	results[0].value().reset();
+	EXPECT_EQ(transport->send(message).code(), v1::UCode::OK);
+	EXPECT_EQ(received[0], 1);
+	EXPECT_EQ(received[1], 2);
+
+	message = create_publish_message(topic_b, {}, std::nullopt);
+	EXPECT_EQ(transport->send(message).code(), v1::UCode::OK);
+	EXPECT_EQ(received[2], 1);
+}
+
+TEST_F(TestZenohUTransport, SkipUnmatchedSends) {  // NOLINT
+#if !defined(Z_FEATURE_UNSTABLE_API)
+	GTEST_SKIP() << "zenoh was built without matching status support";
+#endif
+	constexpr auto RETRY_INTERVAL = std::chrono::milliseconds(10);
+	constexpr auto WAIT_TIMEOUT = std::chrono::seconds(5);
+
+	transport::ZenohUTransportOptions options;
+	options.skip_unmatched_sends = true;
+	auto transport = std::make_shared<transport::ZenohUTransport>(
+	    create_uuri(ENTITY_URI_STR), ZENOH_CONFIG_FILE, options);
+
+	const auto topic = create_uuri("test0", {0x10001, 1}, 0x8000);
+	const auto key = ExposeKeyString::toZenohKeyString("", topic, std::nullopt);
+	const auto message = create_publish_message(topic, {}, std::nullopt);
+
+	// Nobody is subscribed yet
+	EXPECT_EQ(transport->send(message).code(), v1::UCode::OK);
+	ASSERT_EQ(transport->getUnmatchedSkips().count(key), 1);
+	EXPECT_EQ(transport->getUnmatchedSkips().at(key), 1);
+
+	// Once a listener is registered, messages are sent again. Matching
+	// status updates are asynchronous, so sends may still be skipped
+	// until the update arrives.
+	size_t received = 0;
+	std::mutex mutex;
+	std::condition_variable cv;
+	auto handle = transport->registerListener(
+	    [&](const v1::UMessage&) {
+		    std::lock_guard<std::mutex> lock(mutex);
+		    ++received;
+		    cv.notify_all();
+	    },
+	    topic);
+	ASSERT_TRUE(handle);
+
+	size_t sends = 1;
+	const auto deadline = std::chrono::steady_clock::now() + WAIT_TIMEOUT;
+	std::unique_lock<std::mutex> lock(mutex);
+	while ((received == 0) && (std::chrono::steady_clock::now() < deadline)) {
+		lock.unlock();
+		EXPECT_EQ(transport->send(message).code(), v1::UCode::OK);
+		++sends;
+		lock.lock();
+		cv.wait_for(lock, RETRY_INTERVAL, [&received]() {
+			return received > 0;
+		});
+	}
+	EXPECT_EQ(received, 1);
+	// Every send was either skipped or delivered
+	EXPECT_EQ(transport->getUnmatchedSkips()[key], sends - 1);
+}
+
+TEST_F(TestZenohUTransport, LastValueOnRegister) {  // NOLINT
+	constexpr auto REPLY_TIMEOUT = std::chrono::seconds(2);
+
+	const auto topic = create_uuri("test0", {0x10001, 1}, 0x8000);
+
+	transport::ZenohUTransportOptions options;
+	options.last_value_topics.push_back(topic);
+	options.fetch_last_value_on_register = true;
+	auto transport = std::make_shared<transport::ZenohUTransport>(
+	    create_uuri(ENTITY_URI_STR), ZENOH_CONFIG_FILE, options);
+
+	auto message = create_publish_message(topic, {}, std::nullopt);
+	message.set_payload("first");
+	EXPECT_EQ(transport->send(message).code(), v1::UCode::OK);
+	message.set_payload("latest");
+	EXPECT_EQ(transport->send(message).code(), v1::UCode::OK);
+
+	std::promise<std::string> received;
+	auto received_future = received.get_future();
+	auto handle = transport->registerListener(
+	    [&received](const v1::UMessage& last_value) {
+		    received.set_value(last_value.payload());
+	    },
+	    topic);
+	ASSERT_TRUE(handle);
+
+	ASSERT_EQ(received_future.wait_for(REPLY_TIMEOUT),
+	          std::future_status::ready);
+	EXPECT_EQ(received_future.get(), "latest");
+}
+
+TEST_F(TestZenohUTransport, InvokeMethod) {  // NOLINT
+	constexpr uint32_t REQUEST_TTL_MS = 2000;
+	constexpr auto WAIT_TIMEOUT = std::chrono::seconds(5);
+
+	auto transport = std::make_shared<transport::ZenohUTransport>(
+	    create_uuri(ENTITY_URI_STR), ZENOH_CONFIG_FILE);
+
+	const auto client = create_uuri("test0", {0x10001, 1}, 0);
+	const auto method = create_uuri("test0", {0x20002, 1}, 0x10);
+	const auto missing_method = create_uuri("test0", {0x20002, 1}, 0x11);
+	const auto spoofed_method = create_uuri("test0", {0x20002, 1}, 0x12);
+
+	auto make_request = [&client](const v1::UUri& sink) {
+		v1::UMessage request;
+		auto* attributes = request.mutable_attributes();
+		*attributes->mutable_id() =
+		    datamodel::builder::UuidBuilder::getBuilder().build();
+		attributes->set_type(v1::UMessageType::UMESSAGE_TYPE_REQUEST);
+		*attributes->mutable_source() = client;
+		*attributes->mutable_sink() = sink;
+		attributes->set_priority(v1::UPriority::UPRIORITY_CS4);
+		attributes->set_ttl(REQUEST_TTL_MS);
+		request.set_payload("request");
+		return request;
+	};
+
+	// Server echoing requests back as responses from responder
+	auto make_server = [&transport](const v1::UUri& responder) {
+		return [&transport, responder](const v1::UMessage& request) {
+			v1::UMessage response;
+			auto* attributes = response.mutable_attributes();
+			*attributes->mutable_id() =
+			    datamodel::builder::UuidBuilder::getBuilder().build();
+			attributes->set_type(v1::UMessageType::UMESSAGE_TYPE_RESPONSE);
+			*attributes->mutable_source() = responder;
+			*attributes->mutable_sink() = request.attributes().source();
+			*attributes->mutable_reqid() = request.attributes().id();
+			attributes->set_priority(request.attributes().priority());
+			response.set_payload(request.payload());
+			EXPECT_EQ(transport->send(response).code(), v1::UCode::OK);
+		};
+	};
+	auto server = transport->registerListener(
+	    make_server(method), create_uuri("*", {0xFFFF, 0xFF}, 0xFFFF), method);
+	ASSERT_TRUE(server);
+	// Answers on behalf of another method, which must not be accepted
+	auto spoofer = transport->registerListener(
+	    make_server(method), create_uuri("*", {0xFFFF, 0xFF}, 0xFFFF),
+	    spoofed_method);
+	ASSERT_TRUE(spoofer);
+
+	using ResponseOrStatus = transport::ResponseTable::ResponseOrStatus;
+
+	std::promise<std::string> response;
+	auto response_future = response.get_future();
+	auto on_response = [&response](ResponseOrStatus response_or_status) {
+		response.set_value(response_or_status.has_value()
+		                       ? response_or_status.value().payload()
+		                       : "error");
+	};
+	EXPECT_EQ(
+	    transport->invokeMethod(make_request(method), std::move(on_response))
+	        .code(),
+	    v1::UCode::OK);
+	ASSERT_EQ(response_future.wait_for(WAIT_TIMEOUT),
+	          std::future_status::ready);
+	EXPECT_EQ(response_future.get(), "request");
+
+	// Nobody answers this one, so the handler is called once the TTL runs out
+	std::promise<v1::UCode> timeout;
+	auto timeout_future = timeout.get_future();
+	auto on_timeout = [&timeout](ResponseOrStatus response_or_status) {
+		timeout.set_value(response_or_status.has_value()
+		                      ? v1::UCode::OK
+		                      : response_or_status.error().code());
+	};
+	EXPECT_EQ(transport
+	              ->invokeMethod(make_request(missing_method),
+	                             std::move(on_timeout))
+	              .code(),
+	          v1::UCode::OK);
+	ASSERT_EQ(timeout_future.wait_for(WAIT_TIMEOUT),
+	          std::future_status::ready);
+	EXPECT_EQ(timeout_future.get(), v1::UCode::DEADLINE_EXCEEDED);
+
+	std::promise<v1::UCode> spoofed;
+	auto spoofed_future = spoofed.get_future();
+	auto on_spoofed = [&spoofed](ResponseOrStatus response_or_status) {
+		spoofed.set_value(response_or_status.has_value()
+		                      ? v1::UCode::OK
+		                      : response_or_status.error().code());
+	};
+	EXPECT_EQ(transport
+	              ->invokeMethod(make_request(spoofed_method),
+	                             std::move(on_spoofed))
+	              .code(),
+	          v1::UCode::OK);
+	ASSERT_EQ(spoofed_future.wait_for(WAIT_TIMEOUT),
+	          std::future_status::ready);
+	EXPECT_EQ(spoofed_future.get(), v1::UCode::DEADLINE_EXCEEDED);
+
+	// Only requests are accepted
+	EXPECT_EQ(transport
+	              ->invokeMethod(
+	                  create_publish_message(method, {}, REQUEST_TTL_MS),
+	                  [](auto) {})
+	              .code(),
+	          v1::UCode::INVALID_ARGUMENT);
+}
+
+TEST_F(TestZenohUTransport, RecordAndReplayTraffic) {  // NOLINT
+	const auto topic = create_uuri("test0", {0x10001, 1}, 0x8000);
+	const auto capture = std::filesystem::temp_directory_path() /
+	                     "ZenohUTransportTest-RecordAndReplay.cap";
+
+	std::atomic<size_t> received = 0;
+	{
+		transport::ZenohUTransportOptions options;
+		options.record_file = capture;
+		auto transport = std::make_shared<transport::ZenohUTransport>(
+		    create_uuri(ENTITY_URI_STR), ZENOH_CONFIG_FILE, options);
+		auto handle = transport->registerListener(
+		    [&received](const v1::UMessage&) { ++received; }, topic);
+		ASSERT_TRUE(handle);
+
+		EXPECT_EQ(transport
+		              ->send(create_publish_message(topic, {}, std::nullopt))
+		              .code(),
+		          v1::UCode::OK);
+		EXPECT_EQ(received, 1);
+
+		const auto recorded = transport->getRecordedTraffic();
+		EXPECT_EQ(recorded.recorded, 2);
+		EXPECT_EQ(recorded.dropped, 0);
+	}
+
+	// Replaying the capture only sends what was recorded as sent
+	auto transport = std::make_shared<transport::ZenohUTransport>(
+	    create_uuri(ENTITY_URI_STR), ZENOH_CONFIG_FILE);
+	auto handle = transport->registerListener(
+	    [&received](const v1::UMessage&) { ++received; }, topic);
+	ASSERT_TRUE(handle);
+
+	const auto stats = transport::TrafficReplayer::replay(
+	    *transport, capture, transport::TrafficReplayer::Options{});
+	EXPECT_EQ(stats.sent, 1);
+	EXPECT_EQ(stats.failed, 0);
+	EXPECT_EQ(received, 2);
+	std::filesystem::remove(capture);
+}
+
+TEST_F(TestZenohUTransport, MeasureLatency) {  // NOLINT
+	const auto topic = create_uuri("test0", {0x10001, 1}, 0x8000);
+
+	transport::ZenohUTransportOptions options;
+	options.measure_latency = true;
+	auto transport = std::make_shared<transport::ZenohUTransport>(
+	    create_uuri(ENTITY_URI_STR), ZENOH_CONFIG_FILE, options);
+
+	auto handle = transport->registerListener(
+	    [](const v1::UMessage&) {
+		    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+	    },
+	    topic);
+	ASSERT_TRUE(handle);
+	EXPECT_EQ(
+	    transport->send(create_publish_message(topic, {}, std::nullopt)).code(),
+	    v1::UCode::OK);
+
+	const auto latencies = transport->getLatencies();
+	ASSERT_EQ(latencies.publish_to_delivery.size(), 1);
+	EXPECT_EQ(latencies.publish_to_delivery.begin()->second.count, 1);
+	ASSERT_EQ(latencies.delivery_to_callback.size(), 1);
+	const auto& callback = latencies.delivery_to_callback.begin()->second;
+	EXPECT_EQ(callback.count, 1);
+	EXPECT_GE(callback.max, std::chrono::milliseconds(10));
+}
+
+TEST_F(TestZenohUTransport, PullSubscription) {  // NOLINT
+	constexpr size_t CAPACITY = 4;
+	constexpr size_t NUM_MESSAGES = 6;
+	constexpr auto WAIT_TIMEOUT = std::chrono::milliseconds(50);
+	constexpr auto LONG_TIMEOUT = std::chrono::seconds(5);
+
+	const auto topic = create_uuri("test0", {0x10001, 1}, 0x8000);
+	auto transport = std::make_shared<transport::ZenohUTransport>(
+	    create_uuri(ENTITY_URI_STR), ZENOH_CONFIG_FILE);
+
+	transport::PullSubscription::Config config;
+	config.capacity = 0;
+	auto invalid = transport->createPullSubscription(topic, {}, config);
+	ASSERT_FALSE(invalid);
+	EXPECT_EQ(invalid.error().code(), v1::UCode::INVALID_ARGUMENT);
+
+	config.capacity = CAPACITY;
+	config.overflow = transport::PullSubscription::OverflowPolicy::DROP_OLDEST;
+	auto subscription = transport->createPullSubscription(topic, {}, config);
+	ASSERT_TRUE(subscription);
+	auto& pull = *subscription.value();
+	EXPECT_FALSE(pull.tryReceive().has_value());
+
+	for (size_t i = 0; i < NUM_MESSAGES; ++i) {
+		auto message = create_publish_message(topic, {}, std::nullopt);
+		message.set_payload(std::to_string(i));
+		EXPECT_EQ(transport->send(message).code(), v1::UCode::OK);
+	}
+
+	// The two oldest messages were dropped when the ring was full
+	std::vector<v1::UMessage> drained;
+	EXPECT_EQ(pull.drain(drained, 2), 2);
+	ASSERT_EQ(drained.size(), 2);
+	EXPECT_EQ(drained[0].payload(), "2");
+	EXPECT_EQ(drained[1].payload(), "3");
+
+	auto received = pull.receive(WAIT_TIMEOUT);
+	ASSERT_TRUE(received.has_value());
+	EXPECT_EQ(received->payload(), "4");
+	received = pull.tryReceive();
+	ASSERT_TRUE(received.has_value());
+	EXPECT_EQ(received->payload(), "5");
+
+	const auto start = std::chrono::steady_clock::now();
+	EXPECT_FALSE(pull.receive(WAIT_TIMEOUT).has_value());
+	EXPECT_GE(std::chrono::steady_clock::now() - start, WAIT_TIMEOUT);
+	EXPECT_EQ(pull.drain(drained, CAPACITY), 0);
+
+	// A waiting receiver gets a message shortly after it arrives, not at
+	// the end of its timeout
+	auto send_later = [&transport, &topic, WAIT_TIMEOUT]() {
+		std::this_thread::sleep_for(WAIT_TIMEOUT);
+		return transport->send(create_publish_message(topic, {}, std::nullopt))
+		    .code();
+	};
+	auto sender = std::async(std::launch::async, send_later);
+	const auto wait_start = std::chrono::steady_clock::now();
+	EXPECT_TRUE(pull.receive(LONG_TIMEOUT).has_value());
+	EXPECT_LT(std::chrono::steady_clock::now() - wait_start, LONG_TIMEOUT);
+	EXPECT_EQ(sender.get(), v1::UCode::OK);
+}
+
+TEST_F(TestZenohUTransport, BatchSubscription) {  // NOLINT
+	constexpr size_t MAX_BATCH = 4;
+	constexpr auto MAX_DELAY = std::chrono::milliseconds(200);
+	constexpr auto WAIT_TIMEOUT = std::chrono::seconds(5);
+
+	const auto topic = create_uuri("test0", {0x10001, 1}, 0x8003);
+	auto transport = std::make_shared<transport::ZenohUTransport>(
+	    create_uuri(ENTITY_URI_STR), ZENOH_CONFIG_FILE);
+
+	std::mutex mutex;
+	std::condition_variable delivered;
+	std::vector<std::vector<std::string>> batches;
+	// The third batch throws after being recorded
+	auto on_batch = [&](std::vector<v1::UMessage>& messages) {
+		std::vector<std::string> payloads;
+		for (auto& message : messages) {
+			payloads.push_back(std::move(*message.mutable_payload()));
+		}
+		std::lock_guard<std::mutex> lock(mutex);
+		batches.push_back(std::move(payloads));
+		delivered.notify_one();
+		if (batches.size() == 3) {
+			throw std::runtime_error("batch callback failed");
+		}
+	};
+
+	transport::BatchSubscription::Config config;
+	config.max_batch = 0;
+	auto invalid =
+	    transport->createBatchSubscription(topic, {}, config, on_batch);
+	ASSERT_FALSE(invalid);
+	EXPECT_EQ(invalid.error().code(), v1::UCode::INVALID_ARGUMENT);
+
+	config.max_batch = MAX_BATCH;
+	config.max_delay = MAX_DELAY;
+	auto subscription =
+	    transport->createBatchSubscription(topic, {}, config, on_batch);
+	ASSERT_TRUE(subscription);
+
+	auto send = [&](size_t from, size_t to) {
+		for (size_t i = from; i < to; ++i) {
+			auto message = create_publish_message(topic, {}, std::nullopt);
+			message.set_payload(std::to_string(i));
+			EXPECT_EQ(transport->send(message).code(), v1::UCode::OK);
+		}
+	};
+	auto wait_for_batches = [&](size_t count) {
+		std::unique_lock<std::mutex> lock(mutex);
+		return delivered.wait_for(lock, WAIT_TIMEOUT, [&]() {
+			return batches.size() >= count;
+		});
+	};
+
+	// A full batch is delivered without waiting for the delay
+	auto start = std::chrono::steady_clock::now();
+	send(0, MAX_BATCH);
+	ASSERT_TRUE(wait_for_batches(1));
+	EXPECT_LT(std::chrono::steady_clock::now() - start, MAX_DELAY);
+
+	// A partial batch is delivered once the delay has passed
+	start = std::chrono::steady_clock::now();
+	send(MAX_BATCH, MAX_BATCH + 2);
+	ASSERT_TRUE(wait_for_batches(2));
+	EXPECT_GE(std::chrono::steady_clock::now() - start, MAX_DELAY);
+
+	// Batches after one whose callback threw are still delivered
+	send(MAX_BATCH + 2, (2 * MAX_BATCH) + 2);
+	ASSERT_TRUE(wait_for_batches(3));
+	send((2 * MAX_BATCH) + 2, (3 * MAX_BATCH) + 2);
+	ASSERT_TRUE(wait_for_batches(4));
+
+	std::lock_guard<std::mutex> lock(mutex);
+	ASSERT_EQ(batches.size(), 4);
+	EXPECT_EQ(batches[0], (std::vector<std::string>{"0", "1", "2", "3"}));
+	EXPECT_EQ(batches[1], (std::vector<std::string>{"4", "5"}));
+	EXPECT_EQ(batches[2], (std::vector<std::string>{"6", "7", "8", "9"}));
+	EXPECT_EQ(batches[3], (std::vector<std::string>{"10", "11", "12", "13"}));
+	EXPECT_EQ(subscription.value()->dropped(), 0);
+}
+
+TEST_F(TestZenohUTransport, ShapingRejectsOverLimit) {  // NOLINT
+	const auto topic = create_uuri("test0", {0x10001, 1}, 0x8000);
+
+	transport::TrafficShaper::Rule rule;
+	rule.priority = v1::UPriority::UPRIORITY_CS1;
+	rule.bytes_per_second = 1;
+	rule.burst_bytes = 100;
+	rule.over_limit = transport::TrafficShaper::OverLimit::REJECT;
+	transport::ZenohUTransportOptions options;
+	options.shaping_rules.push_back(rule);
+	auto transport = std::make_shared<transport::ZenohUTransport>(
+	    create_uuri(ENTITY_URI_STR), ZENOH_CONFIG_FILE, options);
+
+	const auto message = create_publish_message(topic, {}, std::nullopt);
+	EXPECT_EQ(transport->send(message).code(), v1::UCode::OK);
+	EXPECT_EQ(transport->send(message).code(),
+	          v1::UCode::RESOURCE_EXHAUSTED);
+
+	const auto stats = transport->getShapingStats();
+	ASSERT_EQ(stats.size(), 1);
+	EXPECT_EQ(stats[0].sent_messages, 1);
+	EXPECT_EQ(stats[0].rejected, 1);
+}
+
+TEST_F(TestZenohUTransport, ShapedSendIsNotLastValue) {  // NOLINT
+	constexpr auto REPLY_TIMEOUT = std::chrono::seconds(2);
+	const auto topic = create_uuri("test0", {0x10001, 1}, 0x8000);
+
+	transport::TrafficShaper::Rule rule;
+	rule.priority = v1::UPriority::UPRIORITY_CS1;
+	rule.bytes_per_second = 1;
+	rule.burst_bytes = 100;
+	rule.over_limit = transport::TrafficShaper::OverLimit::REJECT;
+	transport::ZenohUTransportOptions options;
+	options.shaping_rules.push_back(rule);
+	options.last_value_topics.push_back(topic);
+	options.fetch_last_value_on_register = true;
+	auto transport = std::make_shared<transport::ZenohUTransport>(
+	    create_uuri(ENTITY_URI_STR), ZENOH_CONFIG_FILE, options);
+
+	auto message = create_publish_message(topic, {}, std::nullopt);
+	message.set_payload("sent");
+	EXPECT_EQ(transport->send(message).code(), v1::UCode::OK);
+	message.set_payload("rejected");
+	EXPECT_EQ(transport->send(message).code(),
+	          v1::UCode::RESOURCE_EXHAUSTED);
+
+	std::promise<std::string> received;
+	auto received_future = received.get_future();
+	auto handle = transport->registerListener(
+	    [&received](const v1::UMessage& last_value) {
+		    received.set_value(last_value.payload());
+	    },
+	    topic);
+	ASSERT_TRUE(handle);
+
+	ASSERT_EQ(received_future.wait_for(REPLY_TIMEOUT),
+	          std::future_status::ready);
+	EXPECT_EQ(received_future.get(), "sent");
+}
+
+TEST_F(TestZenohUTransport, OpenSessionAsync) {  // NOLINT
+	constexpr auto OPEN_TIMEOUT = std::chrono::seconds(5);
+	const auto topic = create_uuri("test0", {0x10001, 1}, 0x8000);
+
+	transport::ZenohUTransportOptions options;
+	options.open_session_async = true;
+	auto transport = std::make_shared<transport::ZenohUTransport>(
+	    create_uuri(ENTITY_URI_STR), ZENOH_CONFIG_FILE, options);
+
+	// Both are queued if the session is still opening, and replayed in
+	// order once it is open
+	std::atomic<size_t> received = 0;
+	auto handle = transport->registerListener(
+	    [&received](const v1::UMessage&) { ++received; }, topic);
+	ASSERT_TRUE(handle);
+	EXPECT_EQ(
+	    transport->send(create_publish_message(topic, {}, std::nullopt)).code(),
+	    v1::UCode::OK);
+
+	ASSERT_TRUE(transport->waitUntilOpen(OPEN_TIMEOUT));
+	EXPECT_EQ(received, 1);
+
+	const auto timings = transport->getStartupTimings();
+	EXPECT_GT(timings.open_session.count(), 0);
+	EXPECT_GE(timings.until_open, timings.open_session);
+	ASSERT_TRUE(timings.until_first_send.has_value());
+	ASSERT_TRUE(timings.until_first_delivery.has_value());
+	EXPECT_GE(*timings.until_first_delivery, *timings.until_first_send);
+}
+
+struct ExposeSendSession : public transport::ZenohUTransport {
+	template <typename... Args>
+	static auto sendSessionIndex(Args&&... args) {
+		return transport::ZenohUTransport::sendSessionIndex(
+		    std::forward<Args>(args)...);
+	}
+};
+
+TEST_F(TestZenohUTransport, SendSessions) {  // NOLINT
+	constexpr size_t NUM_SESSIONS = 3;
+	constexpr uint32_t NUM_TOPICS = 32;
+	constexpr uint32_t NUM_SEQUENCES = 3;
+	constexpr auto CONNECT_DELAY = std::chrono::milliseconds(500);
+	constexpr auto DELIVERY_TIMEOUT = std::chrono::seconds(5);
+	const std::array<v1::UPriority, 7> priorities = {
+	    v1::UPriority::UPRIORITY_CS0, v1::UPriority::UPRIORITY_CS1,
+	    v1::UPriority::UPRIORITY_CS2, v1::UPriority::UPRIORITY_CS3,
+	    v1::UPriority::UPRIORITY_CS4, v1::UPriority::UPRIORITY_CS5,
+	    v1::UPriority::UPRIORITY_CS6};
+
+	// The extra sessions of the sender have no listen endpoint, and reach
+	// the receiver through the connect endpoint they share with the
+	// first session.
+	const auto configs =
+	    test::makeLinkedConfigs("ZenohUTransportTest-SendSessions");
+	auto rx = std::make_shared<transport::ZenohUTransport>(
+	    create_uuri("//test0/10002/1/0"), configs.listener);
+	transport::ZenohUTransportOptions options;
+	options.send_sessions = NUM_SESSIONS;
+	auto tx = std::make_shared<transport::ZenohUTransport>(
+	    create_uuri(ENTITY_URI_STR), configs.connector, options);
+
+	// Received sequence numbers by topic and priority
+	using Received = std::map<std::pair<uint32_t, int>, std::vector<uint32_t>>;
+	Received received;
+	size_t num_received = 0;
+	std::mutex mutex;
+	std::condition_variable cv;
+	auto handle = rx->registerListener(
+	    [&](const v1::UMessage& message) {
+		    std::lock_guard<std::mutex> lock(mutex);
+		    received[{message.attributes().source().resource_id(),
+		              message.attributes().priority()}]
+		        .push_back(static_cast<uint32_t>(
+		            std::stoul(message.payload())));
+		    ++num_received;
+		    cv.notify_all();
+	    },
+	    create_uuri("test0", {0x10001, 1}, 0xFFFF));
+	ASSERT_TRUE(handle);
+	std::this_thread::sleep_for(CONNECT_DELAY);
+
+	// Every session sends some of the topics
+	std::set<size_t> sessions;
+	for (uint32_t topic = 0; topic < NUM_TOPICS; ++topic) {
+		const auto key = ExposeKeyString::toZenohKeyString(
+		    "", create_uuri("test0", {0x10001, 1}, 0x8000 + topic),
+		    std::nullopt);
+		sessions.insert(
+		    ExposeSendSession::sendSessionIndex(key, NUM_SESSIONS));
+	}
+	EXPECT_EQ(sessions.size(), NUM_SESSIONS);
+
+	for (uint32_t sequence = 0; sequence < NUM_SEQUENCES; ++sequence) {
+		for (auto priority : priorities) {
+			for (uint32_t topic = 0; topic < NUM_TOPICS; ++topic) {
+				auto message = create_publish_message(
+				    create_uuri("test0", {0x10001, 1}, 0x8000 + topic), {},
+				    std::nullopt);
+				message.mutable_attributes()->set_priority(priority);
+				message.set_payload(std::to_string(sequence));
+				EXPECT_EQ(tx->send(message).code(), v1::UCode::OK);
+			}
+		}
+	}
+
+	// Each topic is sent in order at every priority, whichever session
+	// it is on
+	const size_t expected = NUM_TOPICS * priorities.size() * NUM_SEQUENCES;
+	std::unique_lock<std::mutex> lock(mutex);
+	EXPECT_TRUE(cv.wait_for(lock, DELIVERY_TIMEOUT,
+	                        [&]() { return num_received == expected; }));
+	ASSERT_EQ(received.size(), NUM_TOPICS * priorities.size());
+	for (const auto& [topic_priority, sequences] : received) {
+		EXPECT_EQ(sequences, (std::vector<uint32_t>{0, 1, 2}));
+	}
+}
+
+TEST_F(TestZenohUTransport, SendToSinks) {  // NOLINT
+	constexpr size_t NUM_SINKS = 3;
+	constexpr auto WAIT_TIMEOUT = std::chrono::seconds(5);
+	const auto source = create_uuri("test0", {0x10001, 1}, 0x8001);
+
+	auto transport = std::make_shared<transport::ZenohUTransport>(
+	    create_uuri(ENTITY_URI_STR), ZENOH_CONFIG_FILE);
+
+	std::vector<v1::UUri> sinks;
+	std::array<size_t, NUM_SINKS> received{};
+	size_t total_received = 0;
+	std::mutex mutex;
+	std::condition_variable cv;
+	std::vector<transport::ZenohUTransport::ListenHandle> handles;
+	for (size_t index = 0; index < NUM_SINKS; ++index) {
+		sinks.push_back(create_uuri(
+		    "test0", {static_cast<uint32_t>(0x20001 + index), 1}, 0));
+		auto handle = transport->registerListener(
+		    [&, index](const v1::UMessage& message) {
+			    EXPECT_EQ(message.attributes().sink().ue_id(),
+			              sinks[index].ue_id());
+			    EXPECT_EQ(message.payload(), "payload");
+			    std::lock_guard<std::mutex> lock(mutex);
+			    ++received[index];
+			    ++total_received;
+			    cv.notify_all();
+		    },
+		    source, sinks.back());
+		ASSERT_TRUE(handle);
+		handles.push_back(std::move(handle).value());
+	}
+
+	auto notification = create_publish_message(source, {}, std::nullopt);
+	notification.mutable_attributes()->set_type(
+	    v1::UMessageType::UMESSAGE_TYPE_NOTIFICATION);
+	// The last sink is invalid, and only that one fails
+	auto targets = sinks;
+	targets.push_back(create_uuri("test0", {0x20001, 1}, 0x8000));
+
+	const auto statuses = transport->sendToSinks(notification, targets);
+	ASSERT_EQ(statuses.size(), targets.size());
+	for (size_t index = 0; index < NUM_SINKS; ++index) {
+		EXPECT_EQ(statuses[index].code(), v1::UCode::OK);
+	}
+	EXPECT_EQ(statuses.back().code(), v1::UCode::INVALID_ARGUMENT);
+
+	std::unique_lock<std::mutex> lock(mutex);
+	EXPECT_TRUE(cv.wait_for(lock, WAIT_TIMEOUT, [&total_received]() {
+		return total_received == NUM_SINKS;
+	}));
+	for (const auto& count : received) {
+		EXPECT_EQ(count, 1);
+	}
+}
+
+TEST_F(TestZenohUTransport, SuppressDuplicates) {  // NOLINT
+	const auto topic = create_uuri("test0", {0x10001, 1}, 0x8002);
+
+	transport::ZenohUTransportOptions options;
+	options.suppress_duplicates = transport::DuplicateFilter::Config{};
+	auto transport = std::make_shared<transport::ZenohUTransport>(
+	    create_uuri(ENTITY_URI_STR), ZENOH_CONFIG_FILE, options);
+
+	std::atomic<size_t> received = 0;
+	auto handle = transport->registerListener(
+	    [&received](const v1::UMessage&) { ++received; }, topic);
+	ASSERT_TRUE(handle);
+
+	// The same message sent twice is only delivered once
+	const auto message = create_publish_message(topic, {}, std::nullopt);
+	EXPECT_EQ(transport->send(message).code(), v1::UCode::OK);
+	EXPECT_EQ(transport->send(message).code(), v1::UCode::OK);
+	EXPECT_EQ(transport->send(create_publish_message(topic, {}, std::nullopt))
+	              .code(),
+	          v1::UCode::OK);
+
+	EXPECT_EQ(received, 2);
+	const auto suppressed = transport->getSuppressedDuplicates();
+	ASSERT_EQ(suppressed.size(), 1);
+	EXPECT_EQ(suppressed.begin()->second, 1);
+}
+
+TEST_F(TestZenohUTransport, SlowListenerWatchdog) {  // NOLINT
+	constexpr auto THRESHOLD = std::chrono::milliseconds(10);
+	constexpr auto SLOW_CALL = std::chrono::milliseconds(50);
+	constexpr auto WAIT_TIMEOUT = std::chrono::seconds(5);
+	const auto topic = create_uuri("test0", {0x10001, 1}, 0x8004);
+
+	std::atomic<size_t> reports = 0;
+	transport::ZenohUTransportOptions options;
+	options.slow_listener_watchdog = transport::SlowListenerConfig{};
+	options.slow_listener_watchdog->threshold = THRESHOLD;
+	options.slow_listener_watchdog->offload = true;
+	options.slow_listener_watchdog->hook =
+	    [&reports, &topic](const transport::SlowListenerCall& call) {
+		    EXPECT_EQ(call.listener_id, 1);
+		    ASSERT_TRUE(call.source_filter.has_value());
+		    EXPECT_EQ(call.source_filter->SerializeAsString(),
+		              topic.SerializeAsString());
+		    EXPECT_FALSE(call.sink_filter.has_value());
+		    EXPECT_TRUE(call.offloaded);
+		    ++reports;
+	    };
+	auto transport = std::make_shared<transport::ZenohUTransport>(
+	    create_uuri(ENTITY_URI_STR), ZENOH_CONFIG_FILE, options);
+
+	// The first call is slow. Later ones block until released.
+	size_t received = 0;
+	bool released = false;
+	std::thread::id caller;
+	std::mutex mutex;
+	std::condition_variable cv;
+	auto handle = transport->registerListener(
+	    [&, SLOW_CALL, WAIT_TIMEOUT](const v1::UMessage&) {
+		    std::unique_lock<std::mutex> lock(mutex);
+		    if (received == 0) {
+			    lock.unlock();
+			    std::this_thread::sleep_for(SLOW_CALL);
+			    lock.lock();
+		    } else {
+			    caller = std::this_thread::get_id();
+			    cv.wait_for(lock, WAIT_TIMEOUT, [&released]() {
+				    return released;
+			    });
+		    }
+		    ++received;
+		    cv.notify_all();
+	    },
+	    topic);
+	ASSERT_TRUE(handle);
+
+	// The first call runs on the sending thread and is reported. Later
+	// ones are offloaded, so they no longer hold up the sender.
+	const auto message = create_publish_message(topic, {}, std::nullopt);
+	EXPECT_EQ(transport->send(message).code(), v1::UCode::OK);
+	EXPECT_EQ(reports, 1);
+	EXPECT_EQ(transport->send(message).code(), v1::UCode::OK);
+
+	std::unique_lock<std::mutex> lock(mutex);
+	EXPECT_EQ(received, 1);
+	released = true;
+	cv.notify_all();
+	EXPECT_TRUE(cv.wait_for(lock, WAIT_TIMEOUT,
+	                        [&received]() { return received == 2; }));
+	EXPECT_NE(caller, std::this_thread::get_id());
+	lock.unlock();
+	EXPECT_EQ(reports, 1);
+
+	const auto slow_calls = transport->getSlowListenerCalls();
+	ASSERT_EQ(slow_calls.size(), 1);
+	EXPECT_EQ(slow_calls.begin()->second.count, 1);
+	EXPECT_GE(slow_calls.begin()->second.max, SLOW_CALL);
+}
+
+// Destroys the transport while a listener call runs on the receive
+// scheduler and another one on the offload thread. The scheduled call
+// returns last, and is then checked by the watchdog.
+TEST_F(TestZenohUTransport, DestroyWhileSlowListenersRun) {  // NOLINT
+	constexpr auto THRESHOLD = std::chrono::milliseconds(10);
+	constexpr auto SLOW_CALL = std::chrono::milliseconds(100);
+	constexpr auto WAIT_TIMEOUT = std::chrono::seconds(5);
+	const auto offloaded_topic = create_uuri("test0", {0x10001, 1}, 0x8007);
+	const auto scheduled_topic = create_uuri("test0", {0x10001, 1}, 0x8008);
+
+	std::atomic<size_t> reports = 0;
+	transport::ZenohUTransportOptions options;
+	options.receive_scheduler = transport::ReceiveScheduler::Config{};
+	options.slow_listener_watchdog = transport::SlowListenerConfig{};
+	options.slow_listener_watchdog->threshold = THRESHOLD;
+	options.slow_listener_watchdog->offload = true;
+	options.slow_listener_watchdog->hook =
+	    [&reports](const transport::SlowListenerCall&) { ++reports; };
+	auto transport = std::make_shared<transport::ZenohUTransport>(
+	    create_uuri(ENTITY_URI_STR), ZENOH_CONFIG_FILE, options);
+
+	std::atomic<size_t> started = 0;
+	std::atomic<size_t> finished = 0;
+	auto slow_listener = [&started, &finished](auto duration) {
+		return [&started, &finished, duration](const v1::UMessage&) {
+			++started;
+			std::this_thread::sleep_for(duration);
+			++finished;
+		};
+	};
+	auto offloaded_handle = transport->registerListener(
+	    slow_listener(SLOW_CALL), offloaded_topic);
+	auto scheduled_handle = transport->registerListener(
+	    slow_listener(3 * SLOW_CALL), scheduled_topic);
+	ASSERT_TRUE(offloaded_handle);
+	ASSERT_TRUE(scheduled_handle);
+
+	auto wait_until = [WAIT_TIMEOUT, THRESHOLD](auto&& done) {
+		const auto deadline = std::chrono::steady_clock::now() + WAIT_TIMEOUT;
+		while (!done() && (std::chrono::steady_clock::now() < deadline)) {
+			std::this_thread::sleep_for(THRESHOLD);
+		}
+		return done();
+	};
+
+	// The first call on offloaded_topic gets its listener offloaded
+	EXPECT_EQ(transport
+	              ->send(create_publish_message(offloaded_topic, {},
+	                                            std::nullopt))
+	              .code(),
+	          v1::UCode::OK);
+	ASSERT_TRUE(wait_until([&reports]() { return reports == 1; }));
+
+	EXPECT_EQ(transport
+	              ->send(create_publish_message(offloaded_topic, {},
+	                                            std::nullopt))
+	              .code(),
+	          v1::UCode::OK);
+	EXPECT_EQ(transport
+	              ->send(create_publish_message(scheduled_topic, {},
+	                                            std::nullopt))
+	              .code(),
+	          v1::UCode::OK);
+	ASSERT_TRUE(wait_until([&started]() { return started == 3; }));
+
+	// Calls in progress finish before the transport is gone
+	offloaded_handle.value().reset();
+	scheduled_handle.value().reset();
+	transport.reset();
+	EXPECT_EQ(finished, 3);
+	EXPECT_EQ(reports, 2);
+}
+
+TEST_F(TestZenohUTransport, LargePayloadLane) {  // NOLINT
+	constexpr size_t MIN_SIZE = 1024;
+	constexpr auto QUIET_PERIOD = std::chrono::milliseconds(100);
+	constexpr uint32_t REQUEST_TTL_MS = 2000;
+	const auto bulk_topic = create_uuri("test0", {0x10001, 1}, 0x8005);
+	const auto small_topic = create_uuri("test0", {0x10001, 1}, 0x8006);
+	const auto method = create_uuri("test0", {0x20002, 1}, 0x10);
+
+	transport::ZenohUTransportOptions options;
+	options.large_payload_lane = transport::LargePayloadLane{};
+	options.large_payload_lane->min_size = MIN_SIZE;
+	options.large_payload_lane->quiet_period = QUIET_PERIOD;
+	auto transport = std::make_shared<transport::ZenohUTransport>(
+	    create_uuri(ENTITY_URI_STR), ZENOH_CONFIG_FILE, options);
+
+	std::vector<size_t> sizes;
+	auto handle = transport->registerListener(
+	    [&sizes](const v1::UMessage& message) {
+		    sizes.push_back(message.payload().size());
+	    },
+	    bulk_topic);
+	ASSERT_TRUE(handle);
+
+	auto send = [&transport](const v1::UUri& topic, size_t size) {
+		auto message = create_publish_message(topic, {}, std::nullopt);
+		message.set_payload(std::string(size, 'x'));
+		EXPECT_EQ(transport->send(message).code(), v1::UCode::OK);
+	};
+	// Once the topic has sent a large payload, its small ones follow it
+	// in the bulk lane. Other topics are not affected.
+	send(bulk_topic, 1);
+	send(bulk_topic, MIN_SIZE);
+	const auto large_sent = std::chrono::steady_clock::now();
+	send(bulk_topic, 2);
+	send(small_topic, 3);
+
+	// Once the topic has been quiet for long enough, its small payloads
+	// are back in the normal lane. The quiet period is timed from the
+	// large send, which had returned by large_sent.
+	std::this_thread::sleep_until(large_sent + QUIET_PERIOD);
+	send(bulk_topic, 4);
+	EXPECT_EQ(sizes, (std::vector<size_t>{1, MIN_SIZE, 2, 4}));
+
+	// RPC messages stay in the normal lane, whatever their size
+	v1::UMessage request;
+	auto* attributes = request.mutable_attributes();
+	*attributes->mutable_id() =
+	    datamodel::builder::UuidBuilder::getBuilder().build();
+	attributes->set_type(v1::UMessageType::UMESSAGE_TYPE_REQUEST);
+	*attributes->mutable_source() = create_uuri(ENTITY_URI_STR);
+	*attributes->mutable_sink() = method;
+	attributes->set_priority(v1::UPriority::UPRIORITY_CS4);
+	attributes->set_ttl(REQUEST_TTL_MS);
+	request.set_payload(std::string(MIN_SIZE, 'x'));
+	EXPECT_EQ(transport->send(request).code(), v1::UCode::OK);
+
+	const auto bulk_sends = transport->getBulkLaneSends();
+	ASSERT_EQ(bulk_sends.size(), 1);
+	EXPECT_EQ(bulk_sends.begin()->second, 2);
+}
+
 }  // namespace uprotocol
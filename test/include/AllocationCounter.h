@@ -0,0 +1,83 @@
+// SPDX-FileCopyrightText: 2024 Contributors to the Eclipse Foundation
+//
+// See the NOTICE file(s) distributed with this work for additional
+// information regarding copyright ownership.
+//
+// This program and the accompanying materials are made available under the
+// terms of the Apache License Version 2.0 which is available at
+// https://www.apache.org/licenses/LICENSE-2.0
+//
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef UP_TRANSPORT_ZENOH_CPP_TEST_ALLOCATIONCOUNTER_H
+#define UP_TRANSPORT_ZENOH_CPP_TEST_ALLOCATIONCOUNTER_H
+
+// Replaces the global operator new and delete with versions that count
+// allocations per thread. Must be included by exactly one source file of
+// a test executable.
+//
+// Only allocations made through operator new are counted. Those made by
+// zenoh itself, which is written in Rust, go straight to malloc.
+
+#include <cstddef>
+#include <cstdlib>
+#include <new>
+
+namespace uprotocol::test {
+
+struct AllocationCount {
+	size_t allocations = 0;
+	size_t bytes = 0;
+
+	AllocationCount operator-(const AllocationCount& other) const {
+		return {allocations - other.allocations, bytes - other.bytes};
+	}
+
+	AllocationCount& operator+=(const AllocationCount& other) {
+		allocations += other.allocations;
+		bytes += other.bytes;
+		return *this;
+	}
+};
+
+// NOLINTNEXTLINE(*-avoid-non-const-global-variables)
+inline thread_local AllocationCount thread_allocations;
+
+/// @brief Allocations made so far by the calling thread.
+inline AllocationCount threadAllocations() { return thread_allocations; }
+
+}  // namespace uprotocol::test
+
+// GCC sees through the replacement operators and flags the free() of
+// memory from operator new.
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wmismatched-new-delete"
+#endif
+
+void* operator new(size_t size) {
+	++uprotocol::test::thread_allocations.allocations;
+	uprotocol::test::thread_allocations.bytes += size;
+	if (void* ptr = std::malloc(size == 0 ? 1 : size)) {  // NOLINT
+		return ptr;
+	}
+	throw std::bad_alloc();
+}
+
+void* operator new[](size_t size) { return operator new(size); }
+
+void operator delete(void* ptr) noexcept { std::free(ptr); }  // NOLINT
+
+void operator delete[](void* ptr) noexcept { std::free(ptr); }  // NOLINT
+
+void operator delete(void* ptr, size_t) noexcept { std::free(ptr); }  // NOLINT
+
+void operator delete[](void* ptr, size_t) noexcept {
+	std::free(ptr);  // NOLINT
+}
+
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic pop
+#endif
+
+#endif  // UP_TRANSPORT_ZENOH_CPP_TEST_ALLOCATIONCOUNTER_H
@@ -0,0 +1,105 @@
+// SPDX-FileCopyrightText: 2024 Contributors to the Eclipse Foundation
+//
+// See the NOTICE file(s) distributed with this work for additional
+// information regarding copyright ownership.
+//
+// This program and the accompanying materials are made available under the
+// terms of the Apache License Version 2.0 which is available at
+// https://www.apache.org/licenses/LICENSE-2.0
+//
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef UP_TRANSPORT_ZENOH_CPP_TEST_BENCHMARKUTILS_H
+#define UP_TRANSPORT_ZENOH_CPP_TEST_BENCHMARKUTILS_H
+
+#include <unistd.h>
+#include <up-cpp/datamodel/builder/Uuid.h>
+#include <uprotocol/v1/umessage.pb.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "LinkedConfigs.h"
+
+namespace uprotocol::benchmark {
+
+using test::LinkedConfigs;
+using test::makeLinkedConfigs;
+
+inline v1::UUri makeUUri(uint32_t ue_id, uint16_t resource_id) {
+	v1::UUri uuri;
+	uuri.set_authority_name(static_cast<std::string>("test0"));
+	uuri.set_ue_id(ue_id);
+	uuri.set_ue_version_major(1);
+	uuri.set_resource_id(resource_id);
+	return uuri;
+}
+
+inline v1::UMessage makePublishMessage(
+    const v1::UUri& topic, std::string payload,
+    v1::UPriority priority = v1::UPriority::UPRIORITY_CS1) {
+	v1::UMessage message;
+	auto* attributes = message.mutable_attributes();
+	*attributes->mutable_id() =
+	    datamodel::builder::UuidBuilder::getBuilder().build();
+	attributes->set_type(v1::UMessageType::UMESSAGE_TYPE_PUBLISH);
+	*attributes->mutable_source() = topic;
+	attributes->set_priority(priority);
+	attributes->set_payload_format(v1::UPayloadFormat::UPAYLOAD_FORMAT_RAW);
+	message.set_payload(std::move(payload));
+	return message;
+}
+
+/// @brief Resident set size of this process, in bytes.
+inline size_t currentRssBytes() {
+	size_t total_pages = 0;
+	size_t resident_pages = 0;
+	std::ifstream("/proc/self/statm") >> total_pages >> resident_pages;
+	return resident_pages * static_cast<size_t>(sysconf(_SC_PAGESIZE));
+}
+
+inline int64_t nowNs() {
+	return std::chrono::duration_cast<std::chrono::nanoseconds>(
+	           std::chrono::steady_clock::now().time_since_epoch())
+	    .count();
+}
+
+struct LatencySummary {
+	size_t count = 0;
+	double p50_us = 0;
+	double p99_us = 0;
+	double max_us = 0;
+};
+
+inline LatencySummary summarize(std::vector<int64_t> samples_ns) {
+	LatencySummary summary;
+	summary.count = samples_ns.size();
+	if (samples_ns.empty()) {
+		return summary;
+	}
+	std::sort(samples_ns.begin(), samples_ns.end());
+	auto percentile = [&samples_ns](size_t pct) {
+		const size_t index = ((samples_ns.size() - 1) * pct) / 100;
+		return static_cast<double>(samples_ns[index]) / 1000.0;
+	};
+	summary.p50_us = percentile(50);
+	summary.p99_us = percentile(99);
+	summary.max_us = percentile(100);
+	return summary;
+}
+
+inline void report(const std::string& name, const LatencySummary& summary) {
+	std::cout << "[ BENCH    ] " << name << ": n=" << summary.count
+	          << " p50=" << summary.p50_us << "us"
+	          << " p99=" << summary.p99_us << "us"
+	          << " max=" << summary.max_us << "us" << std::endl;
+}
+
+}  // namespace uprotocol::benchmark
+
+#endif  // UP_TRANSPORT_ZENOH_CPP_TEST_BENCHMARKUTILS_H
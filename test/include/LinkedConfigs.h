@@ -0,0 +1,91 @@
+// SPDX-FileCopyrightText: 2024 Contributors to the Eclipse Foundation
+//
+// See the NOTICE file(s) distributed with this work for additional
+// information regarding copyright ownership.
+//
+// This program and the accompanying materials are made available under the
+// terms of the Apache License Version 2.0 which is available at
+// https://www.apache.org/licenses/LICENSE-2.0
+//
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef UP_TRANSPORT_ZENOH_CPP_TEST_LINKEDCONFIGS_H
+#define UP_TRANSPORT_ZENOH_CPP_TEST_LINKEDCONFIGS_H
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <system_error>
+
+namespace uprotocol::test {
+
+/// @brief Zenoh configurations for two sessions linked over loopback TCP.
+///
+/// Samples sent between sessions are delivered on the receiving session's
+/// RX thread, whereas samples sent within one session are delivered on the
+/// sending thread. Tests of receive-side behavior need the former.
+struct LinkedConfigs {
+	std::filesystem::path listener;
+	std::filesystem::path connector;
+};
+
+/// @brief Finds a loopback TCP port that is currently free.
+///
+/// The kernel picks the port, so tests running in parallel don't collide
+/// on it. The port is released again before it is returned.
+inline uint16_t freeLoopbackPort() {
+	const int socket_fd = ::socket(AF_INET, SOCK_STREAM, 0);
+	if (socket_fd < 0) {
+		throw std::system_error(errno, std::generic_category(), "socket");
+	}
+
+	sockaddr_in address{};
+	address.sin_family = AF_INET;
+	address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+	address.sin_port = 0;
+	socklen_t length = sizeof(address);
+	auto* generic_address = reinterpret_cast<sockaddr*>(&address);
+	const bool bound =
+	    (::bind(socket_fd, generic_address, sizeof(address)) == 0) &&
+	    (::getsockname(socket_fd, generic_address, &length) == 0);
+	const int error = errno;
+	::close(socket_fd);
+	if (!bound) {
+		throw std::system_error(error, std::generic_category(), "bind");
+	}
+	return ntohs(address.sin_port);
+}
+
+/// @brief Writes linked configurations using the given port.
+inline LinkedConfigs makeLinkedConfigs(const std::string& name,
+                                       uint16_t port) {
+	const auto dir = std::filesystem::temp_directory_path();
+	const std::string endpoint =
+	    "\"tcp/127.0.0.1:" + std::to_string(port) + "\"";
+
+	LinkedConfigs configs{dir / (name + "_listener.json5"),
+	                      dir / (name + "_connector.json5")};
+	std::ofstream(configs.listener)
+	    << "{mode: \"peer\", listen: {endpoints: [" << endpoint
+	    << "]}, scouting: {multicast: {enabled: false}}}";
+	std::ofstream(configs.connector)
+	    << "{mode: \"peer\", connect: {endpoints: [" << endpoint
+	    << "]}, scouting: {multicast: {enabled: false}}}";
+	return configs;
+}
+
+/// @brief Writes linked configurations using a free port.
+inline LinkedConfigs makeLinkedConfigs(const std::string& name) {
+	return makeLinkedConfigs(name, freeLoopbackPort());
+}
+
+}  // namespace uprotocol::test
+
+#endif  // UP_TRANSPORT_ZENOH_CPP_TEST_LINKEDCONFIGS_H